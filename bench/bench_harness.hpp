@@ -0,0 +1,521 @@
+#ifndef SMEL_BENCH_HARNESS_HPP
+#define SMEL_BENCH_HARNESS_HPP
+
+#include <cmath>
+#include <chrono>
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+
+namespace bench {
+
+// Keeps the compiler from discarding a value computed only for timing
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile T sink;
+  sink = value;
+#endif
+}
+
+
+struct Options
+{
+  std::string filter;
+  std::string json_path;
+  std::string baseline_path;
+  double threshold_percent = 10.0;
+  int samples = 15;
+  double min_sample_ms = 2.0;
+  bool counters = false;
+};
+
+struct Result
+{
+  std::string name;
+  std::size_t evals_per_sample = 0;
+  int samples = 0;
+  double ns_per_eval = 0;     // median over samples
+  double mean_ns = 0;
+  double stddev_ns = 0;
+  double min_ns = 0;
+  double evals_per_second = 0;
+  std::vector<std::pair<std::string,double>> counters;  // per eval, over all samples
+  double max_relative_error = -1;  // against the reference, if one was given
+  double error_bound = 0;
+};
+
+
+// Hardware counters of this thread from perf_event_open, user space only. A
+// counter the kernel or the machine refuses (e.g. in a container) is reported
+// once on stderr and left out.
+class Counters
+{
+private:
+  struct Counter
+  {
+    std::string name;
+    int fd;
+  };
+
+  std::vector<Counter> counters_;
+
+#if defined(__linux__)
+  void Open(const std::string& name, const std::uint32_t type, const std::uint64_t config)
+  {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    if (fd < 0) {
+      std::cerr << "counter " << name << " unavailable: " << std::strerror(errno) << "\n";
+      return;
+    }
+    counters_.push_back({name, fd});
+  }
+
+  static constexpr std::uint64_t CacheMisses(const std::uint64_t cache)
+  {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  }
+
+  // FP_ARITH_INST_RETIRED with every umask, on Intel since Broadwell; the raw
+  // code means something else on other vendors
+  static bool HasIntelFpArith()
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx)) {
+      return false;
+    }
+    return ebx == 0x756e6547 && edx == 0x49656e69 && ecx == 0x6c65746e;  // "GenuineIntel"
+#else
+    return false;
+#endif
+  }
+#endif
+
+public:
+  Counters()
+  {
+#if defined(__linux__)
+    Open("cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    Open("instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    Open("branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    Open("l1d_misses", PERF_TYPE_HW_CACHE, CacheMisses(PERF_COUNT_HW_CACHE_L1D));
+    Open("llc_misses", PERF_TYPE_HW_CACHE, CacheMisses(PERF_COUNT_HW_CACHE_LL));
+    if (HasIntelFpArith()) {
+      Open("fp_arith", PERF_TYPE_RAW, 0xffc7);
+    }
+#else
+    std::cerr << "hardware counters need Linux perf_event_open\n";
+#endif
+  }
+
+  Counters(const Counters&) = delete;
+  Counters& operator=(const Counters&) = delete;
+
+  ~Counters()
+  {
+#if defined(__linux__)
+    for (const Counter& c : counters_) {
+      close(c.fd);
+    }
+#endif
+  }
+
+  bool Empty() const
+  { return counters_.empty(); }
+
+  void Start()
+  {
+#if defined(__linux__)
+    for (const Counter& c : counters_) {
+      ioctl(c.fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(c.fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+
+  // Counts since Start, scaled up when the kernel multiplexed a counter
+  std::vector<std::pair<std::string,double>> Stop()
+  {
+    std::vector<std::pair<std::string,double>> values;
+#if defined(__linux__)
+    for (const Counter& c : counters_) {
+      ioctl(c.fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for (const Counter& c : counters_) {
+      std::uint64_t data[3] = {0, 0, 0};  // value, time enabled, time running
+      if (read(c.fd, data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) {
+        continue;
+      }
+      values.emplace_back(c.name, static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]));
+    }
+#endif
+    return values;
+  }
+};
+
+// Instructions per cycle of a counter list, 0 without both counters
+inline double Ipc(const std::vector<std::pair<std::string,double>>& counters)
+{
+  double cycles = 0, instructions = 0;
+  for (const auto& [name, value] : counters) {
+    cycles = (name == "cycles") ? value : cycles;
+    instructions = (name == "instructions") ? value : instructions;
+  }
+  return cycles > 0 ? instructions / cycles : 0;
+}
+
+// |value - reference| / |reference|, 0 where they are equal (so an exact 0 is
+// fine) and infinite where the quotient is NaN, so that NaN results fail
+inline double RelativeError(const double value, const double reference)
+{
+  if (value == reference) {
+    return 0;
+  }
+  const double error = std::abs(value - reference) / std::abs(reference);
+  return std::isnan(error) ? std::numeric_limits<double>::infinity() : error;
+}
+
+
+// A benchmark evaluates one function over a batch of inputs. Run calls it
+// batch after batch until a sample lasts at least min_sample_ms, then times
+// the requested number of samples.
+class Suite
+{
+private:
+  struct Case
+  {
+    std::string name;
+    std::function<double(const std::vector<double>&)> run_batch;
+    const std::vector<double>* inputs;
+    std::function<double(double)> value = nullptr;
+    std::function<double(double)> reference = nullptr;
+    double error_bound = 0;
+  };
+
+  std::vector<Case> cases_;
+
+public:
+  // function(x) is called once per input; it may be an expression or a lambda
+  template<typename Function>
+  void Add(const std::string& name, const std::vector<double>& inputs, const Function& function)
+  {
+    cases_.push_back({name, [function](const std::vector<double>& xs) {
+      double sum = 0;
+      for (const double x : xs) {
+        sum += function(x);
+      }
+      return sum;
+    }, &inputs});
+  }
+
+  // Also checks that function stays within error_bound of reference, relative to
+  // the reference value, at every input
+  template<typename Function, typename Reference>
+  void AddChecked(const std::string& name, const std::vector<double>& inputs, const Function& function,
+    const Reference& reference, const double error_bound)
+  {
+    Add(name, inputs, function);
+    cases_.back().value = function;
+    cases_.back().reference = reference;
+    cases_.back().error_bound = error_bound;
+  }
+
+  // batch(inputs, outputs) is called once per batch and fills outputs[i] from inputs[i]
+  template<typename Batch>
+  void AddBatch(const std::string& name, const std::vector<double>& inputs, const Batch& batch)
+  {
+    cases_.push_back({name, [batch, outputs = std::vector<double>(inputs.size())](const std::vector<double>& xs) mutable {
+      batch(std::span<const double>(xs), std::span<double>(outputs));
+      double sum = 0;
+      for (const double y : outputs) {
+        sum += y;
+      }
+      return sum;
+    }, &inputs});
+  }
+
+  std::vector<Result> Run(const Options& options) const
+  {
+    typedef std::chrono::steady_clock Clock;
+    std::vector<Result> results;
+    std::unique_ptr<Counters> counters;
+    if (options.counters) {
+      counters = std::make_unique<Counters>();
+    }
+    for (const Case& c : cases_) {
+      if (!options.filter.empty() && c.name.find(options.filter) == std::string::npos) {
+        continue;
+      }
+      const std::vector<double>& xs = *c.inputs;
+
+      // calibrate the number of batches per sample
+      std::size_t batches = 1;
+      while (true) {
+        const auto start = Clock::now();
+        for (std::size_t b = 0; b < batches; ++b) {
+          DoNotOptimize(c.run_batch(xs));
+        }
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (ms >= options.min_sample_ms || batches >= (std::size_t(1) << 30)) {
+          break;
+        }
+        batches *= 2;
+      }
+
+      std::vector<double> ns_per_eval;
+      if (counters) {
+        counters->Start();
+      }
+      for (int s = 0; s < options.samples; ++s) {
+        const auto start = Clock::now();
+        for (std::size_t b = 0; b < batches; ++b) {
+          DoNotOptimize(c.run_batch(xs));
+        }
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        ns_per_eval.push_back(ns / static_cast<double>(batches * xs.size()));
+      }
+      std::vector<std::pair<std::string,double>> counts;
+      if (counters) {
+        counts = counters->Stop();
+      }
+
+      Result r;
+      r.name = c.name;
+      r.evals_per_sample = batches * xs.size();
+      r.samples = options.samples;
+      std::vector<double> sorted = ns_per_eval;
+      std::sort(sorted.begin(), sorted.end());
+      const std::size_t n = sorted.size();
+      r.ns_per_eval = (n % 2) ? sorted[n/2] : 0.5 * (sorted[n/2 - 1] + sorted[n/2]);
+      r.min_ns = sorted.front();
+      for (const double v : sorted) {
+        r.mean_ns += v / n;
+      }
+      for (const double v : sorted) {
+        r.stddev_ns += (v - r.mean_ns) * (v - r.mean_ns) / n;
+      }
+      r.stddev_ns = std::sqrt(r.stddev_ns);
+      r.evals_per_second = 1e9 / r.ns_per_eval;
+      if (c.reference) {
+        r.max_relative_error = 0;
+        r.error_bound = c.error_bound;
+        for (const double x : xs) {
+          r.max_relative_error = std::max(r.max_relative_error, RelativeError(c.value(x), c.reference(x)));
+        }
+      }
+      for (const auto& [counter, count] : counts) {
+        r.counters.emplace_back(counter, count / static_cast<double>(r.evals_per_sample * r.samples));
+      }
+      results.push_back(r);
+    }
+    return results;
+  }
+};
+
+
+inline std::string ToJson(const std::vector<Result>& results)
+{
+  std::ostringstream out;
+  out.precision(6);
+  out << "{\n  \"benchmarks\": [\n";
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const Result& r = results[i];
+    out << "    {\"name\": \"" << r.name << "\""
+        << ", \"ns_per_eval\": " << r.ns_per_eval
+        << ", \"mean_ns\": " << r.mean_ns
+        << ", \"stddev_ns\": " << r.stddev_ns
+        << ", \"min_ns\": " << r.min_ns
+        << ", \"evals_per_second\": " << r.evals_per_second
+        << ", \"samples\": " << r.samples
+        << ", \"evals_per_sample\": " << r.evals_per_sample;
+    if (r.max_relative_error >= 0) {
+      out << ", \"max_relative_error\": ";
+      if (std::isfinite(r.max_relative_error)) {
+        out << r.max_relative_error;
+      } else {
+        out << "null";
+      }
+      out << ", \"error_bound\": " << r.error_bound;
+    }
+    if (!r.counters.empty()) {
+      out << ", \"ipc\": " << Ipc(r.counters) << ", \"per_eval\": {";
+      for (std::size_t c = 0; c < r.counters.size(); ++c) {
+        out << (c ? ", \"" : "\"") << r.counters[c].first << "\": " << r.counters[c].second;
+      }
+      out << "}";
+    }
+    out << "}"
+        << (i + 1 < results.size() ? ",\n" : "\n");
+  }
+  out << "  ]\n}\n";
+  return out.str();
+}
+
+// Reads back the name and ns_per_eval of every entry written by ToJson
+inline std::vector<std::pair<std::string,double>> ReadBaseline(const std::string& path)
+{
+  std::ifstream file(path);
+  if (!file) {
+    std::cerr << "cannot read baseline " << path << "\n";
+    std::exit(2);
+  }
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  const std::string text = buffer.str();
+
+  std::vector<std::pair<std::string,double>> entries;
+  const std::string name_key = "\"name\": \"";
+  const std::string ns_key = "\"ns_per_eval\": ";
+  std::size_t pos = 0;
+  while ((pos = text.find(name_key, pos)) != std::string::npos) {
+    pos += name_key.size();
+    const std::size_t end = text.find('"', pos);
+    const std::string name = text.substr(pos, end - pos);
+    const std::size_t ns = text.find(ns_key, end);
+    if (ns == std::string::npos) {
+      break;
+    }
+    entries.emplace_back(name, std::strtod(text.c_str() + ns + ns_key.size(), nullptr));
+    pos = end;
+  }
+  return entries;
+}
+
+// Prints the change of every benchmark against the baseline and returns
+// whether all of them are within threshold_percent of it
+inline bool CompareToBaseline(const std::vector<Result>& results, const std::string& path, const double threshold_percent)
+{
+  const auto baseline = ReadBaseline(path);
+  bool ok = true;
+  std::fprintf(stderr, "%-40s %12s %12s %9s\n", "benchmark", "baseline ns", "current ns", "change");
+  for (const Result& r : results) {
+    const auto it = std::find_if(baseline.begin(), baseline.end(),
+      [&](const auto& entry) { return entry.first == r.name; });
+    if (it == baseline.end()) {
+      std::fprintf(stderr, "%-40s %12s %12.3f %9s\n", r.name.c_str(), "-", r.ns_per_eval, "new");
+      continue;
+    }
+    const double change = 100.0 * (r.ns_per_eval - it->second) / it->second;
+    const bool regressed = change > threshold_percent;
+    ok = ok && !regressed;
+    std::fprintf(stderr, "%-40s %12.3f %12.3f %+8.1f%%%s\n",
+      r.name.c_str(), it->second, r.ns_per_eval, change, regressed ? "  REGRESSION" : "");
+  }
+  return ok;
+}
+
+
+inline Options ParseOptions(int argc, char** argv)
+{
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const auto value = [&]() -> std::string {
+      if (i + 1 >= argc) {
+        std::cerr << "missing value for " << arg << "\n";
+        std::exit(2);
+      }
+      return argv[++i];
+    };
+    if (arg == "--filter") {
+      options.filter = value();
+    } else if (arg == "--json") {
+      options.json_path = value();
+    } else if (arg == "--baseline") {
+      options.baseline_path = value();
+    } else if (arg == "--threshold") {
+      options.threshold_percent = std::stod(value());
+    } else if (arg == "--samples") {
+      options.samples = std::max(1, std::stoi(value()));
+    } else if (arg == "--min-time") {
+      options.min_sample_ms = std::stod(value());
+    } else if (arg == "--counters") {
+      options.counters = true;
+    } else {
+      std::cerr <<
+        "usage: " << argv[0] << " [--filter substring] [--json file] [--samples n] [--min-time ms]\n"
+        "       [--counters] [--baseline file.json [--threshold percent]]\n"
+        "Writes results as JSON to stdout, or to --json file. With --baseline, exits\n"
+        "with status 1 when a benchmark is slower than the baseline by more than\n"
+        "--threshold percent (default 10). With --counters, adds the IPC and per-evaluation\n"
+        "hardware counters (cycles, instructions, branch and cache misses, FP operations)\n"
+        "of every benchmark, as far as perf_event_open grants them. Exits with status 1\n"
+        "when a benchmark checked against a reference exceeds its error bound.\n";
+      std::exit(arg == "--help" ? 0 : 2);
+    }
+  }
+  return options;
+}
+
+// Prints every checked benchmark whose error exceeds its bound and returns
+// whether there was none
+inline bool CheckAccuracy(const std::vector<Result>& results)
+{
+  bool ok = true;
+  for (const Result& r : results) {
+    if (!(r.max_relative_error <= r.error_bound)) {
+      std::fprintf(stderr, "%-40s relative error %.3g above bound %.3g  ACCURACY\n",
+        r.name.c_str(), r.max_relative_error, r.error_bound);
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+// Runs the suite with the command line options; returns the exit status
+inline int Main(const Suite& suite, int argc, char** argv)
+{
+  const Options options = ParseOptions(argc, argv);
+  const std::vector<Result> results = suite.Run(options);
+  const bool accurate = CheckAccuracy(results);
+  const std::string json = ToJson(results);
+  if (options.json_path.empty()) {
+    std::cout << json;
+  } else {
+    std::ofstream(options.json_path) << json;
+  }
+  if (!options.baseline_path.empty()) {
+    return (CompareToBaseline(results, options.baseline_path, options.threshold_percent) && accurate) ? 0 : 1;
+  }
+  return accurate ? 0 : 1;
+}
+
+} // bench namespace
+#endif
@@ -0,0 +1,328 @@
+// Compile-time benchmarks: generates translation units building families of
+// expressions of increasing size or derivative order, compiles each one and
+// reports wall time, peak compiler memory and, with a compiler that supports
+// -ftime-trace (clang), the number of template instantiations. Times are also
+// given above a baseline translation unit that only includes the library, and
+// the growth exponent of that excess between consecutive sizes,
+// log(t2/t1) / log(n2/n1), shows how the metaprogramming scales. POSIX only.
+//
+//   smel_compile_bench [--family name] [--max-size n] [--repeat n] [--codegen]
+//                      [--work-dir dir] [--json file]
+
+#include <cmath>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <filesystem>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#ifndef SMEL_CXX_COMPILER
+#define SMEL_CXX_COMPILER "c++"
+#endif
+
+#ifndef SMEL_INCLUDE_DIR
+#define SMEL_INCLUDE_DIR "include"
+#endif
+
+
+struct Family
+{
+  std::string name;
+  std::string description;
+  std::vector<int> sizes;
+  // body of main() building and evaluating the expression of size n
+  std::function<std::string(int)> source;
+};
+
+struct Measurement
+{
+  std::string family;
+  int size = 0;
+  bool ok = false;
+  double seconds = 0;
+  double excess_seconds = 0;  // above the baseline translation unit
+  double peak_mb = 0;
+  long instantiations = -1;
+};
+
+
+// Sum and product families use distinct terms so that nothing merges away
+static std::string Terms(const int n, const std::string& separator, const std::string& prefix, const int first = 1)
+{
+  std::string out;
+  for (int k = first; k < first + n; ++k) {
+    out += (k > first ? separator : "") + prefix + "(x + Int<" + std::to_string(k) + ">())";
+  }
+  return out;
+}
+
+static std::string Derivatives(const int order)
+{
+  std::string out;
+  for (int k = 0; k < order; ++k) {
+    out += ".Derivative()";
+  }
+  return out;
+}
+
+static std::string Evaluated(const std::string& expr)
+{
+  return "  Symbol x;\n  const auto f = " + expr + ";\n"
+         "  volatile double r = f.Evaluate(0.5);\n  (void)r;\n";
+}
+
+static std::vector<Family> MakeFamilies(const int max_size)
+{
+  const auto up_to = [&](std::vector<int> sizes) {
+    sizes.erase(std::remove_if(sizes.begin(), sizes.end(), [&](int n) { return n > max_size; }), sizes.end());
+    return sizes;
+  };
+  return {
+    {"sum_width", "sum of n terms sin(x + k)", up_to({2, 4, 8, 16, 24}),
+      [](int n) { return Evaluated("(" + Terms(n, " + ", "sin") + ")"); }},
+    {"product_width", "product of n factors sin(x + k)", up_to({2, 4, 8, 16, 24}),
+      [](int n) { return Evaluated("(" + Terms(n, " * ", "sin") + ")"); }},
+    {"sum_merge", "sum of two n-term sums sharing half their terms", up_to({2, 4, 8, 16, 24}),
+      [](int n) {
+        return Evaluated("(" + Terms(n, " + ", "sin") + ") + (" + Terms(n, " + ", "Int<2>() * sin", n/2 + 1) + ")");
+      }},
+    {"product_merge", "product of two n-factor products sharing half their factors", up_to({2, 4, 8, 16, 24}),
+      [](int n) {
+        return Evaluated("(" + Terms(n, " * ", "sin") + ") * (" + Terms(n, " * ", "sin", n/2 + 1) + ")");
+      }},
+    {"sum_derivative_order", "n-th derivative of a sum of 4 terms sin(x + k)", up_to({1, 2, 3, 4}),
+      [](int n) { return Evaluated("(" + Terms(4, " + ", "sin") + ")" + Derivatives(n)); }},
+    {"product_derivative_order", "n-th derivative of a product of 3 factors sin(x + k)", up_to({1, 2, 3, 4}),
+      [](int n) { return Evaluated("(" + Terms(3, " * ", "sin") + ")" + Derivatives(n)); }},
+    {"quotient_derivative_order", "n-th derivative of sin(x) / (x + 1)", up_to({1, 2, 3, 4}),
+      [](int n) { return Evaluated("(sin(x) / (x + Int<1>()))" + Derivatives(n)); }},
+    {"nesting_depth", "n nested sin(cos(...))", up_to({2, 4, 8, 16, 32}),
+      [](int n) {
+        std::string expr = "x";
+        for (int k = 0; k < n; ++k) {
+          expr = std::string(k % 2 ? "cos(" : "sin(") + expr + ")";
+        }
+        return Evaluated(expr + ".Derivative()");
+      }},
+  };
+}
+
+
+// Runs argv, returning the exit status, wall time and peak RSS of the process
+// tree (the compiler driver and the compiler it starts). A process that can't
+// be started or waited for counts as failed, with zero time and memory.
+static bool Run(const std::vector<std::string>& args, double& seconds, double& peak_mb, const bool quiet = false)
+{
+  seconds = 0;
+  peak_mb = 0;
+  std::vector<char*> argv;
+  for (const std::string& a : args) {
+    argv.push_back(const_cast<char*>(a.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  const auto start = std::chrono::steady_clock::now();
+  const pid_t pid = fork();
+  if (pid == 0) {
+    const int null = open("/dev/null", O_WRONLY);
+    dup2(null, STDOUT_FILENO);
+    if (quiet) {
+      dup2(null, STDERR_FILENO);
+    }
+    execvp(argv[0], argv.data());
+    _exit(127);
+  }
+  if (pid == -1) {
+    std::cerr << "cannot start " << args[0] << ": " << std::strerror(errno) << "\n";
+    return false;
+  }
+  int status = 0;
+  rusage usage{};
+  pid_t waited;
+  do {
+    waited = wait4(pid, &status, 0, &usage);
+  } while (waited == -1 && errno == EINTR);
+  if (waited == -1) {
+    std::cerr << "cannot wait for " << args[0] << ": " << std::strerror(errno) << "\n";
+    return false;
+  }
+  seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  peak_mb = usage.ru_maxrss / 1024.0;  // KiB on Linux
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static bool SupportsTimeTrace(const std::filesystem::path& work_dir)
+{
+  const auto source = work_dir / "probe.cpp";
+  std::ofstream(source) << "int main() {}\n";
+  double seconds, peak;
+  return Run({SMEL_CXX_COMPILER, "-ftime-trace", "-fsyntax-only", source.string()}, seconds, peak, true);
+}
+
+// Counts the instantiation events of a -ftime-trace JSON file
+static long CountInstantiations(const std::filesystem::path& trace)
+{
+  std::ifstream file(trace);
+  if (!file) {
+    return -1;
+  }
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  const std::string text = buffer.str();
+  long count = 0;
+  for (const std::string key : {"\"name\":\"InstantiateClass\"", "\"name\":\"InstantiateFunction\""}) {
+    for (std::size_t pos = text.find(key); pos != std::string::npos; pos = text.find(key, pos + 1)) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+
+int main(int argc, char** argv)
+{
+  std::string only_family;
+  std::string json_path;
+  std::filesystem::path work_dir = "compile_bench_work";
+  int max_size = 16;
+  int repeat = 1;
+  bool codegen = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const auto value = [&]() -> std::string {
+      if (i + 1 >= argc) {
+        std::cerr << "missing value for " << arg << "\n";
+        std::exit(2);
+      }
+      return argv[++i];
+    };
+    if (arg == "--family") {
+      only_family = value();
+    } else if (arg == "--max-size") {
+      max_size = std::stoi(value());
+    } else if (arg == "--repeat") {
+      repeat = std::max(1, std::stoi(value()));
+    } else if (arg == "--codegen") {
+      codegen = true;
+    } else if (arg == "--work-dir") {
+      work_dir = value();
+    } else if (arg == "--json") {
+      json_path = value();
+    } else {
+      std::cerr <<
+        "usage: " << argv[0] << " [--family name] [--max-size n] [--repeat n] [--codegen]\n"
+        "       [--work-dir dir] [--json file]\n"
+        "Compiles generated expression families with " SMEL_CXX_COMPILER " (front end only\n"
+        "unless --codegen) and prints a scaling report. --repeat keeps the fastest run.\n";
+      return arg == "--help" ? 0 : 2;
+    }
+  }
+
+  std::filesystem::create_directories(work_dir);
+  const bool time_trace = SupportsTimeTrace(work_dir);
+
+  // Compiles the body of main() as work_dir/stem.cpp, keeping the fastest of repeat runs
+  const auto compile = [&](const std::string& stem_name, const std::string& body) {
+    const auto stem = work_dir / stem_name;
+    const auto source = std::filesystem::path(stem).replace_extension(".cpp");
+    std::ofstream(source) <<
+      "#include \"SMEL/Expressions\"\n"
+      "using namespace SYMBOLIC_NAMESPACE_NAME;\n"
+      "int main()\n{\n" << body << "}\n";
+
+    std::vector<std::string> args = {SMEL_CXX_COMPILER, "-std=c++20", "-I" SMEL_INCLUDE_DIR};
+    if (codegen) {
+      args.insert(args.end(), {"-O2", "-c", source.string(), "-o", std::filesystem::path(stem).replace_extension(".o").string()});
+    } else {
+      args.insert(args.end(), {"-fsyntax-only", source.string()});
+    }
+    if (time_trace) {
+      args.push_back("-ftime-trace");
+      if (!codegen) {
+        // clang names the trace after the object file, which -fsyntax-only doesn't write
+        args.push_back("-ftime-trace=" + std::filesystem::path(stem).replace_extension(".json").string());
+      }
+    }
+
+    Measurement m;
+    m.ok = true;
+    m.seconds = 1e300;
+    for (int r = 0; r < repeat; ++r) {
+      double seconds, peak;
+      m.ok = Run(args, seconds, peak) && m.ok;
+      m.seconds = std::min(m.seconds, seconds);
+      m.peak_mb = std::max(m.peak_mb, peak);
+    }
+    if (time_trace) {
+      m.instantiations = CountInstantiations(std::filesystem::path(stem).replace_extension(".json"));
+    }
+    return m;
+  };
+
+  const Measurement baseline = compile("baseline", "");
+  std::printf("baseline (library only): %.3f s, %.1f MB\n", baseline.seconds, baseline.peak_mb);
+
+  std::vector<Measurement> results;
+  for (const Family& family : MakeFamilies(max_size)) {
+    if (!only_family.empty() && family.name != only_family) {
+      continue;
+    }
+    std::printf("%s: %s\n", family.name.c_str(), family.description.c_str());
+    std::printf("  %6s %10s %10s %10s %10s %14s\n", "n", "seconds", "excess", "peak MB", "growth", "instantiations");
+
+    const Measurement* previous = nullptr;
+    for (const int n : family.sizes) {
+      Measurement m = compile(family.name + "_" + std::to_string(n), family.source(n));
+      m.family = family.name;
+      m.size = n;
+      m.excess_seconds = std::max(m.seconds - baseline.seconds, 1e-3);
+
+      std::string growth = "-";
+      if (previous && previous->ok && m.ok) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.2f",
+          std::log(m.excess_seconds / previous->excess_seconds) / std::log(static_cast<double>(n) / previous->size));
+        growth = buffer;
+      }
+      std::printf("  %6d %10.3f %10.3f %10.1f %10s %14s%s\n", n, m.seconds, m.excess_seconds, m.peak_mb, growth.c_str(),
+        m.instantiations < 0 ? "n/a" : std::to_string(m.instantiations).c_str(),
+        m.ok ? "" : "  FAILED");
+      std::fflush(stdout);
+      results.push_back(m);
+      previous = &results.back();
+    }
+  }
+
+  if (!json_path.empty()) {
+    std::ofstream out(json_path);
+    out << "{\n  \"compiler\": \"" SMEL_CXX_COMPILER "\",\n  \"codegen\": " << (codegen ? "true" : "false")
+        << ",\n  \"baseline_seconds\": " << baseline.seconds << ", \"baseline_peak_mb\": " << baseline.peak_mb
+        << ",\n  \"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+      const Measurement& m = results[i];
+      out << "    {\"family\": \"" << m.family << "\", \"size\": " << m.size
+          << ", \"ok\": " << (m.ok ? "true" : "false")
+          << ", \"seconds\": " << m.seconds << ", \"excess_seconds\": " << m.excess_seconds
+          << ", \"peak_mb\": " << m.peak_mb
+          << ", \"instantiations\": " << m.instantiations << "}"
+          << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+  }
+
+  const bool all_ok = std::all_of(results.begin(), results.end(), [](const Measurement& m) { return m.ok; });
+  return all_ok ? 0 : 1;
+}
@@ -0,0 +1,278 @@
+// Runtime benchmarks of expression evaluation. Every node type is timed on its
+// own, then composite expressions and their 1st to 4th derivatives, each next
+// to the same function written by hand ("hand/...") and, for derivatives, to
+// the same derivative evaluated from a tape ("tape/..."). Type-erased handles
+// are timed per value and per batch ("any/...") against std::function
+// ("function/..."). The Fast and Faster precision tiers ("precision/...") are
+// timed and checked against their documented error bounds, as is mixed
+// precision ("mixed/...", next to plain "float/..."). See
+// bench_harness.hpp for the command line options.
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "SMEL/Expressions"
+#include "bench_harness.hpp"
+
+using namespace SYMBOLIC_NAMESPACE_NAME;
+
+
+// Inputs spread over (0.1, 0.9), inside the domain of every function timed
+static std::vector<double> MakeInputs(const std::size_t n)
+{
+  std::vector<double> xs(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    xs[i] = 0.1 + 0.8 * static_cast<double>(i) / static_cast<double>(n);
+  }
+  return xs;
+}
+
+static double parameter = 1.25;
+
+static void AddNodes(bench::Suite& suite, const std::vector<double>& xs)
+{
+  const Symbol x;
+  const RuntimeConstant<double> c(1.25);
+  const Reference<double> r(parameter);
+
+  suite.Add("node/symbol", xs, x);
+  suite.Add("node/constant_sum", xs, x + Int<3>());
+  suite.Add("node/runtime_constant", xs, c * x);
+  suite.Add("node/reference", xs, r * x);
+  suite.Add("node/negation", xs, -sin(x));
+  suite.Add("node/sum", xs, x + sin(x) + cos(x));
+  suite.Add("node/product", xs, x * sin(x) * cos(x));
+  suite.Add("node/quotient", xs, sin(x) / x);
+  suite.Add("node/power", xs, x ^ c);
+  suite.Add("node/integer_power", xs, pow<3>(x));
+  suite.Add("node/sqrt", xs, sqrt(x));
+  suite.Add("node/exp", xs, exp(x));
+  suite.Add("node/ln", xs, ln(x));
+  suite.Add("node/sin", xs, sin(x));
+  suite.Add("node/cos", xs, cos(x));
+  suite.Add("node/tan", xs, tan(x));
+  suite.Add("node/sec", xs, sec(x));
+  suite.Add("node/csc", xs, csc(x));
+  suite.Add("node/cot", xs, cot(x));
+  suite.Add("node/arcsin", xs, arcsin(x));
+  suite.Add("node/arccos", xs, arccos(x));
+  suite.Add("node/arctan", xs, arctan(x));
+  suite.Add("node/arcsec", xs, arcsec(x + Int<1>()));
+  suite.Add("node/arccsc", xs, arccsc(x + Int<1>()));
+  suite.Add("node/arccot", xs, arccot(x));
+  suite.Add("node/abs", xs, abs(x - Int<1>()));
+
+  suite.Add("hand/node/sin", xs, [](double t) { return std::sin(t); });
+  suite.Add("hand/node/exp", xs, [](double t) { return std::exp(t); });
+  suite.Add("hand/node/ln", xs, [](double t) { return std::log(t); });
+  suite.Add("hand/node/integer_power", xs, [](double t) { return t * t * t; });
+  suite.Add("hand/node/sqrt", xs, [](double t) { return std::sqrt(t); });
+}
+
+static void AddComposites(bench::Suite& suite, const std::vector<double>& xs)
+{
+  const Symbol x;
+  const RuntimeConstant<double> c(1.25);
+
+  const auto poly = pow<4>(x) + Int<3>() * pow<3>(x) - Int<2>() * x + Int<7>();
+  suite.Add("composite/polynomial", xs, poly);
+  suite.Add("hand/composite/polynomial", xs, [](double t) { return t*t*t*t + 3*t*t*t - 2*t + 7; });
+
+  const auto rational = (x + Int<1>()) / (x * x + Int<2>());
+  suite.Add("composite/rational", xs, rational);
+  suite.Add("hand/composite/rational", xs, [](double t) { return (t + 1) / (t*t + 2); });
+
+  const auto gaussian = exp(-(c * x * x));
+  suite.Add("composite/gaussian", xs, gaussian);
+  suite.Add("hand/composite/gaussian", xs, [](double t) { return std::exp(-(1.25 * t * t)); });
+
+  const auto damped = sin(x) * exp(x) + ln(x);
+  suite.Add("composite/damped", xs, damped);
+  suite.Add("hand/composite/damped", xs, [](double t) { return std::sin(t) * std::exp(t) + std::log(t); });
+
+  const auto wide = x * sin(x) * cos(x) * exp(x) * ln(x);
+  suite.Add("composite/wide_product", xs, wide);
+  suite.Add("hand/composite/wide_product", xs,
+    [](double t) { return t * std::sin(t) * std::cos(t) * std::exp(t) * std::log(t); });
+}
+
+static void AddDerivatives(bench::Suite& suite, const std::vector<double>& xs)
+{
+  const Symbol x;
+
+  const auto f = sin(x) * exp(x);
+  const auto d1 = f.Derivative();
+  const auto d2 = d1.Derivative();
+  const auto d3 = d2.Derivative();
+  const auto d4 = d3.Derivative();
+  suite.Add("derivative/damped_1", xs, d1);
+  suite.Add("derivative/damped_2", xs, d2);
+  suite.Add("derivative/damped_3", xs, d3);
+  suite.Add("derivative/damped_4", xs, d4);
+  // (e^x sin x)' = e^x (sin x + cos x), '' = 2 e^x cos x, ''' = 2 e^x (cos x - sin x), '''' = -4 e^x sin x
+  suite.Add("hand/derivative/damped_1", xs, [](double t) { return std::exp(t) * (std::sin(t) + std::cos(t)); });
+  suite.Add("hand/derivative/damped_2", xs, [](double t) { return 2 * std::exp(t) * std::cos(t); });
+  suite.Add("hand/derivative/damped_3", xs, [](double t) { return 2 * std::exp(t) * (std::cos(t) - std::sin(t)); });
+  suite.Add("hand/derivative/damped_4", xs, [](double t) { return -4 * std::exp(t) * std::sin(t); });
+
+  const auto g = x / (x + Int<1>());
+  const auto g1 = g.Derivative();
+  const auto g2 = g1.Derivative();
+  const auto g3 = g2.Derivative();
+  const auto g4 = g3.Derivative();
+  suite.Add("derivative/rational_1", xs, g1);
+  suite.Add("derivative/rational_2", xs, g2);
+  suite.Add("derivative/rational_3", xs, g3);
+  suite.Add("derivative/rational_4", xs, g4);
+  // x/(x+1) = 1 - 1/(x+1), so the n-th derivative is (-1)^(n+1) n! / (x+1)^(n+1)
+  suite.Add("hand/derivative/rational_1", xs, [](double t) { const double u = 1 / (t + 1); return u*u; });
+  suite.Add("hand/derivative/rational_2", xs, [](double t) { const double u = 1 / (t + 1); return -2*u*u*u; });
+  suite.Add("hand/derivative/rational_3", xs, [](double t) { const double u = 1 / (t + 1); return 6*u*u*u*u; });
+  suite.Add("hand/derivative/rational_4", xs, [](double t) { const double u = 1 / (t + 1); return -24*u*u*u*u*u; });
+
+  const auto wide = x * sin(x) * cos(x) * exp(x) * ln(x);
+  suite.Add("derivative/wide_product_1", xs, wide.Derivative());
+  suite.Add("derivative/wide_product_2", xs, wide.Derivative().Derivative());
+}
+
+static void AddTapes(bench::Suite& suite, const std::vector<double>& xs)
+{
+  const Symbol x;
+
+  const auto f = sin(x) * exp(x);
+  suite.Add("tape/derivative/damped_1", xs, Derivative<1,0>(f));
+  suite.Add("tape/derivative/damped_4", xs, Derivative<4,0>(f));
+  suite.Add("tape/derivative/damped_8", xs, Derivative<8,0>(f));
+
+  const auto g = x / (x + Int<1>());
+  suite.Add("tape/derivative/rational_1", xs, Derivative<1,0>(g));
+  suite.Add("tape/derivative/rational_4", xs, Derivative<4,0>(g));
+
+  const auto wide = x * sin(x) * cos(x) * exp(x) * ln(x);
+  suite.Add("tape/derivative/wide_product_2", xs, Derivative<2,0>(wide));
+}
+
+static void AddErased(bench::Suite& suite, const std::vector<double>& xs)
+{
+  const Symbol x;
+
+  const AnyExpression<double> damped = sin(x) * exp(x) + ln(x);
+  const std::function<double(double)> damped_function = sin(x) * exp(x) + ln(x);
+  suite.Add("any/composite/damped", xs, damped);
+  suite.AddBatch("any/batch/composite/damped", xs,
+    [damped](std::span<const double> in, std::span<double> out) { damped.EvaluateBatch(in, out); });
+  suite.Add("function/composite/damped", xs, damped_function);
+
+  const AnyExpression<double> rational = (x + Int<1>()) / (x * x + Int<2>());
+  const std::function<double(double)> rational_function = (x + Int<1>()) / (x * x + Int<2>());
+  suite.Add("any/composite/rational", xs, rational);
+  suite.AddBatch("any/batch/composite/rational", xs,
+    [rational](std::span<const double> in, std::span<double> out) { rational.EvaluateBatch(in, out); });
+  suite.Add("function/composite/rational", xs, rational_function);
+
+  // one formula per channel, all channels over the same block
+  const std::vector<AnyExpression<double>> channels = {
+    sin(x) * exp(x), (x + Int<1>()) / (x * x + Int<2>()), pow<4>(x) + Int<3>() * pow<3>(x), sqrt(x) * cos(x) };
+  const std::vector<std::function<double(double)>> channel_functions = {
+    sin(x) * exp(x), (x + Int<1>()) / (x * x + Int<2>()), pow<4>(x) + Int<3>() * pow<3>(x), sqrt(x) * cos(x) };
+  suite.AddBatch("any/batch/channels", xs, [channels](std::span<const double> in, std::span<double> out) {
+    for (const AnyExpression<double>& channel : channels) {
+      channel.EvaluateBatch(in, out);
+    }
+  });
+  suite.AddBatch("function/channels", xs, [channel_functions](std::span<const double> in, std::span<double> out) {
+    for (const std::function<double(double)>& channel : channel_functions) {
+      for (std::size_t i = 0; i < in.size(); ++i) {
+        out[i] = channel(in[i]);
+      }
+    }
+  });
+}
+
+// Inputs spread over [lo,hi]
+static std::vector<double> MakeRange(const double lo, const double hi, const std::size_t n)
+{
+  std::vector<double> xs(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    xs[i] = lo + (hi - lo) * static_cast<double>(i) / static_cast<double>(n - 1);
+  }
+  return xs;
+}
+
+// Each expression timed with Policy and checked against the precise value
+template<typename Policy>
+static void AddPolicy(bench::Suite& suite, const std::string& tier, const double bound)
+{
+  const Symbol x;
+  static const std::vector<double> wide = MakeRange(-100, 100, 1024);
+  static const std::vector<double> exponents = MakeRange(-30, 30, 1024);
+  static const std::vector<double> positive = MakeRange(1e-3, 1e3, 1024);
+  static const std::vector<double> unit = MakeRange(-0.999, 0.999, 1024);
+  static const std::vector<double> xs = MakeInputs(1024);
+
+  const auto add = [&](const std::string& name, const std::vector<double>& inputs, const auto& expr, const double scale) {
+    suite.AddChecked("precision/" + tier + "/" + name, inputs,
+      [expr](double t) { return EvaluateWith<Policy>(expr, t); },
+      [expr](double t) { return expr.Evaluate(t); }, scale * bound);
+  };
+  add("sin", wide, sin(x), 1);
+  add("cos", wide, cos(x), 1);
+  add("tan", wide, tan(x), 1);
+  add("exp", exponents, exp(x), 1);
+  add("ln", positive, ln(x), 1);
+  add("arctan", wide, arctan(x), 1);
+  add("arcsin", unit, arcsin(x), 1);
+  add("arccos", unit, arccos(x), 1);
+  // reciprocals of one approximation, or quotients of two
+  add("sec", wide, sec(x), 2);
+  add("cot", wide, cot(x), 2);
+  add("csc", wide, csc(x), 2);
+  // exp(y log x), with the errors of exp and log added up
+  add("pow", positive, x ^ RuntimeConstant<double>(1.7), 2);
+  // relative errors of the factors add up
+  add("composite/wide_product", xs, x * sin(x) * cos(x) * exp(x) * ln(x), 4);
+  add("composite/gaussian", xs, exp(-(RuntimeConstant<double>(1.25) * x * x)), 2);
+}
+
+static void AddPrecision(bench::Suite& suite)
+{
+  AddPolicy<Fast>(suite, "fast", 1.2e-7);
+  AddPolicy<Faster>(suite, "faster", 8e-5);
+}
+
+// Functions in float with double arithmetic, against float throughout
+static void AddMixed(bench::Suite& suite, const std::vector<double>& xs)
+{
+  const Symbol x;
+
+  const auto add = [&](const std::string& name, const auto& expr, const double bound) {
+    suite.AddChecked("mixed/" + name, xs, [expr](double t) { return EvaluateMixed(expr, t); },
+      [expr](double t) { return expr.Evaluate(t); }, bound);
+    suite.Add("float/" + name, xs, [expr](double t) { return static_cast<double>(expr.Evaluate(static_cast<float>(t))); });
+  };
+  add("node/sin", sin(x), 2e-7);
+  add("node/exp", exp(x), 2e-7);
+  add("composite/polynomial", pow<4>(x) + Int<3>() * pow<3>(x) - Int<2>() * x + Int<7>(), 1e-15);
+  add("composite/gaussian", exp(-(RuntimeConstant<double>(1.25) * x * x)), 2e-7);
+  add("composite/wide_product", x * sin(x) * cos(x) * exp(x) * ln(x), 1e-6);
+  // a sum that crosses zero between the inputs, hence the looser relative bound
+  add("derivative/wide_product_2", (x * sin(x) * cos(x) * exp(x) * ln(x)).Derivative().Derivative(), 1e-4);
+}
+
+
+int main(int argc, char** argv)
+{
+  static const std::vector<double> xs = MakeInputs(1024);
+
+  bench::Suite suite;
+  AddNodes(suite, xs);
+  AddComposites(suite, xs);
+  AddDerivatives(suite, xs);
+  AddTapes(suite, xs);
+  AddErased(suite, xs);
+  AddPrecision(suite);
+  AddMixed(suite, xs);
+  return bench::Main(suite, argc, argv);
+}
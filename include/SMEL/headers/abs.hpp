@@ -2,6 +2,7 @@
 #define SYMBOLIC_INCLUDE_ABS_HPP
 
 #include <cassert>
+#include <cmath>
 
 #include "symbolic_base.hpp"
 #include "constants.hpp"
@@ -12,20 +13,22 @@ template<typename SymType>
 class Signum : public SymbolicBase< Signum<SymType> >
 {
 private:
-  typename std::conditional_t<SymType::is_leaf, const SymType&, const SymType> expr_;
+  [[no_unique_address]] Branch<SymType> expr_;
 
 public:
   static constexpr bool is_leaf = false;
   static constexpr bool is_dynamic = SymType::is_dynamic;
 
+  constexpr Signum() = default;
+
   constexpr Signum(const SymType& expr) : expr_{expr}
   {}
 
   template<typename FloatType>
   FloatType Evaluate(const FloatType input) const
   {
-    assert(expr_.Evaluate(input) != 0);
-    return (expr_.Evaluate(input) < static_cast<FloatType>(0))
+    assert(expr_->Evaluate(input) != 0);
+    return (expr_->Evaluate(input) < static_cast<FloatType>(0))
             ? static_cast<FloatType>(-1) : static_cast<FloatType>(1);
   }
 
@@ -38,7 +41,12 @@ public:
 
   std::string str() const
   {
-    return "sgn(" + expr_.str() + ")";
+    return "sgn(" + expr_->str() + ")";
+  }
+
+  constexpr auto Argument() const
+  {
+    return *expr_;
   }
 };
 
@@ -47,38 +55,45 @@ template<typename SymType>
 class AbsoluteValue : public SymbolicBase< AbsoluteValue<SymType> >
 {
 private:
-  typename std::conditional_t<SymType::is_leaf, const SymType&, const SymType> expr_;
+  [[no_unique_address]] Branch<SymType> expr_;
 
 public:
   static constexpr bool is_leaf = false;
   static constexpr bool is_dynamic = SymType::is_dynamic;
 
+  constexpr AbsoluteValue() = default;
+
   constexpr AbsoluteValue(const SymType& expr) : expr_{expr}
   {}
 
   template<typename FloatType>
   FloatType Evaluate(const FloatType input) const
   {
-    FloatType val = expr_.Evaluate(input);
-    return (val < static_cast<FloatType>(0)) ? -val : val;
+    using std::abs;
+    return abs(expr_->Evaluate(input));
   }
 
   constexpr auto Derivative() const
   {
-    return Signum(expr_) * expr_.Derivative();
+    return Signum(*expr_) * expr_->Derivative();
   }
 
   std::string str() const
   {
-    return "|" + expr_.str() + "|";
+    return "|" + expr_->str() + "|";
+  }
+
+  constexpr auto Argument() const
+  {
+    return *expr_;
   }
 };
 
 
 template<typename SymType>
-auto abs(const SymbolicBase<SymType> expr)
+auto abs(const SymbolicBase<SymType>& expr)
 {
-  return AbsoluteValue<SymType>(expr.derived());
+  return ApplyConstructionRules(AbsoluteValue<SymType>(expr.derived()));
 }
 
 
@@ -0,0 +1,276 @@
+#ifndef SYMBOLIC_INCLUDE_ANY_HPP
+#define SYMBOLIC_INCLUDE_ANY_HPP
+
+#include <new>
+#include <span>
+#include <string>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+#include "symbolic_base.hpp"
+#include "prototyping.hpp"
+#include "structure.hpp"
+#include "cost.hpp"
+#include "bind.hpp"
+#include "tape.hpp"
+
+
+// Bytes of expression kept inside an AnyExpression; larger ones go to the heap
+#ifndef SYMBOLIC_ANY_BUFFER_SIZE
+#define SYMBOLIC_ANY_BUFFER_SIZE 64
+#endif
+
+// Orders of AnyExpression::Derivative taken on the expression itself before
+// switching to tapes. Each is compiled for every expression stored.
+#ifndef SYMBOLIC_ANY_DERIVATIVE_DEPTH
+#define SYMBOLIC_ANY_DERIVATIVE_DEPTH 2
+#endif
+
+
+namespace SYMBOLIC_NAMESPACE_NAME {
+
+template<typename T>
+class AnyExpression;
+
+// Operations of an AnyExpression on its hidden expression
+template<typename T>
+struct AnyConcept
+{
+  virtual ~AnyConcept() = default;
+
+  virtual T Evaluate(T input) const = 0;
+  virtual void EvaluateBatch(std::span<const T> inputs, std::span<T> outputs) const = 0;
+  virtual AnyExpression<T> Derivative() const = 0;
+  virtual Tape<T> ToTape() const = 0;
+  virtual std::string str() const = 0;
+
+  // Copy or move into buffer when the model fits there, else onto the heap
+  virtual AnyConcept* CopyTo(void* buffer) const = 0;
+  virtual AnyConcept* MoveTo(void* buffer) noexcept = 0;
+};
+
+template<typename SymType, typename T, std::size_t Depth>
+struct AnyModel;
+
+template<typename Model>
+constexpr bool any_fits_buffer_v = sizeof(Model) <= SYMBOLIC_ANY_BUFFER_SIZE
+  && alignof(Model) <= alignof(std::max_align_t)
+  && std::is_nothrow_move_constructible_v<Model>;
+
+
+// ANY EXPRESSION
+// Handle to an expression of any type evaluating in T, so that different
+// expressions fit in one container. Expressions up to SYMBOLIC_ANY_BUFFER_SIZE
+// bytes are stored in the handle. Every call through it is indirect:
+// EvaluateBatch pays that once per block instead of once per value.
+template<typename T = double>
+class AnyExpression : public SymbolicBase< AnyExpression<T> >
+{
+private:
+  alignas(std::max_align_t) unsigned char buffer_[SYMBOLIC_ANY_BUFFER_SIZE];
+  AnyConcept<T>* self_;
+
+  template<typename SymType, typename, std::size_t>
+  friend struct AnyModel;
+
+  template<typename Model, typename... Args>
+  AnyConcept<T>* Emplace(Args&&... args)
+  {
+    if constexpr (any_fits_buffer_v<Model>) {
+      return new (buffer_) Model(std::forward<Args>(args)...);
+    } else {
+      return new Model(std::forward<Args>(args)...);
+    }
+  }
+
+  template<typename Model, typename SymType>
+  AnyExpression(std::in_place_type_t<Model>, const SymType& expr) : self_{ Emplace<Model>(expr) }
+  {}
+
+  bool IsLocal() const
+  { return static_cast<const void*>(self_) == static_cast<const void*>(buffer_); }
+
+  void Reset() noexcept
+  {
+    if (IsLocal()) {
+      self_->~AnyConcept();
+    } else {
+      delete self_;
+    }
+    self_ = nullptr;
+  }
+
+  // Leaves other empty: it may only be assigned to or destroyed
+  void Take(AnyExpression& other) noexcept
+  {
+    if (other.IsLocal()) {
+      self_ = other.self_->MoveTo(buffer_);
+      other.Reset();
+    } else {
+      self_ = std::exchange(other.self_, nullptr);
+    }
+  }
+
+public:
+  static constexpr bool is_leaf = false;
+  static constexpr bool is_dynamic = true;
+
+  // Holds the constant 0
+  AnyExpression() : AnyExpression(Zero<>())
+  {}
+
+  template<typename SymType>
+    requires (!std::is_same_v<SymType, AnyExpression<T>>)
+  AnyExpression(const SymbolicBase<SymType>& expr)
+    : self_{ Emplace<AnyModel<SymType,T,0>>(expr.derived()) }
+  {}
+
+  AnyExpression(const AnyExpression& other) : self_{ other.self_->CopyTo(buffer_) }
+  {}
+
+  AnyExpression(AnyExpression&& other) noexcept
+  {
+    Take(other);
+  }
+
+  AnyExpression& operator=(const AnyExpression& other)
+  {
+    if (this != &other) {
+      AnyExpression copy(other);
+      Reset();
+      Take(copy);
+    }
+    return *this;
+  }
+
+  AnyExpression& operator=(AnyExpression&& other) noexcept
+  {
+    if (this != &other) {
+      Reset();
+      Take(other);
+    }
+    return *this;
+  }
+
+  ~AnyExpression()
+  {
+    Reset();
+  }
+
+  template<typename FloatType>
+  FloatType Evaluate(const FloatType input) const
+  {
+    return static_cast<FloatType>(self_->Evaluate(static_cast<T>(input)));
+  }
+
+  // outputs[i] = value at inputs[i], for every input
+  void EvaluateBatch(const std::span<const T> inputs, const std::span<T> outputs) const
+  {
+    assert(outputs.size() >= inputs.size());
+    self_->EvaluateBatch(inputs, outputs);
+  }
+
+  AnyExpression Derivative() const
+  {
+    return self_->Derivative();
+  }
+
+  Tape<T> ToTape() const
+  {
+    return self_->ToTape();
+  }
+
+  std::string str() const
+  {
+    return self_->str();
+  }
+
+  // Whether the expression is stored in the handle rather than on the heap
+  bool IsInline() const
+  { return IsLocal(); }
+};
+
+template<typename SymType, typename T, std::size_t Depth>
+struct AnyModel : public AnyConcept<T>
+{
+  SymType expr;
+
+  explicit AnyModel(const SymType& e) : expr{e}
+  {}
+
+  T Evaluate(const T input) const override
+  {
+    return expr.Evaluate(input);
+  }
+
+  void EvaluateBatch(const std::span<const T> inputs, const std::span<T> outputs) const override
+  {
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+      outputs[i] = expr.Evaluate(inputs[i]);
+    }
+  }
+
+  // Static derivatives for the first SYMBOLIC_ANY_DERIVATIVE_DEPTH orders while
+  // they stay within SYMBOLIC_DERIVATIVE_BUDGET nodes, tapes after that
+  AnyExpression<T> Derivative() const override
+  {
+    if constexpr (std::is_same_v<SymType, Tape<T>>) {
+      return AnyExpression<T>(expr.Derivative());
+    }
+    else if constexpr (Depth < SYMBOLIC_ANY_DERIVATIVE_DEPTH
+        && node_count_v<decltype(expr.Derivative())> <= SYMBOLIC_DERIVATIVE_BUDGET) {
+      typedef decltype(expr.Derivative()) DerivativeType;
+      return AnyExpression<T>(std::in_place_type<AnyModel<DerivativeType,T,Depth+1>>, expr.Derivative());
+    }
+    else {
+      return AnyExpression<T>(SYMBOLIC_NAMESPACE_NAME::ToTape<T>(expr).Derivative());
+    }
+  }
+
+  Tape<T> ToTape() const override
+  {
+    return SYMBOLIC_NAMESPACE_NAME::ToTape<T>(expr);
+  }
+
+  std::string str() const override
+  {
+    return expr.str();
+  }
+
+  AnyConcept<T>* CopyTo(void* buffer) const override
+  {
+    if constexpr (any_fits_buffer_v<AnyModel>) {
+      return new (buffer) AnyModel(*this);
+    } else {
+      return new AnyModel(*this);
+    }
+  }
+
+  AnyConcept<T>* MoveTo(void* buffer) noexcept override
+  {
+    if constexpr (any_fits_buffer_v<AnyModel>) {
+      return new (buffer) AnyModel(std::move(*this));
+    } else {
+      return new AnyModel(std::move(*this));
+    }
+  }
+};
+
+// Opaque to Children/Rebuild, like a tape: references inside are not reported
+template<typename T>
+struct node_children<AnyExpression<T>>
+{
+  typedef type_list<> type;
+};
+
+template<typename T>
+struct depends_on_input<AnyExpression<T>>
+{
+  static constexpr bool value = true;
+};
+
+
+} // Symbolic namespace
+#endif
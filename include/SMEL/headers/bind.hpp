@@ -0,0 +1,435 @@
+#ifndef SYMBOLIC_INCLUDE_BIND_HPP
+#define SYMBOLIC_INCLUDE_BIND_HPP
+
+#include <array>
+#include <tuple>
+#include <string>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+
+#include "metaprogramming.hpp"
+#include "symbolic_base.hpp"
+#include "prototyping.hpp"
+#include "constants.hpp"
+#include "ordering.hpp"
+#include "hash.hpp"
+#include "structure.hpp"
+#include "intern.hpp"
+#include "cost.hpp"
+
+
+namespace SYMBOLIC_NAMESPACE_NAME {
+
+// DEPENDS ON INPUT
+// Whether the value of a tree changes with the input, i.e. it has a Symbol leaf
+template<typename SymType>
+struct depends_on_input;
+
+template<typename... Syms>
+constexpr bool DependsOnInputOf(type_list<Syms...>)
+{
+  return (false || ... || depends_on_input<Syms>::value);
+}
+
+template<typename SymType>
+struct depends_on_input
+{
+  typedef cost_node_t<SymType> Node;
+  static constexpr bool value = is_symbol_v<Node> || DependsOnInputOf(node_children_t<Node>());
+};
+
+template<typename SymType>
+constexpr bool depends_on_input_v = depends_on_input<SymType>::value;
+
+
+// A subtree is hoisted when it is computed from runtime values alone. Lone
+// leaves are left in place, reading them is already as cheap as the cache.
+template<typename SymType>
+constexpr bool is_hoistable_v =
+  SymType::is_dynamic && !depends_on_input_v<SymType> && (node_children_t<cost_node_t<SymType>>::size > 0);
+
+// Indices of the children of a sum or product that do (Dependent = true) or
+// don't depend on the input
+template<bool Dependent, class... Syms>
+constexpr auto InputIndices()
+{
+  constexpr bool depends[] = { depends_on_input_v<Syms>..., false };
+  constexpr std::size_t count = (std::size_t(0) + ... + (depends_on_input_v<Syms> == Dependent ? 1 : 0));
+  constexpr auto indices = [&]() {
+    std::array<std::size_t, count> found{};
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < sizeof...(Syms); ++i) {
+      if (depends[i] == Dependent) {
+        found[n++] = i;
+      }
+    }
+    return found;
+  }();
+  return [&]<std::size_t... J>(std::index_sequence<J...>) {
+    return std::index_sequence<indices[J]...>();
+  }(std::make_index_sequence<count>());
+}
+
+// A sum or product whose terms that don't depend on the input, at least one of
+// them dynamic, are evaluated together into a single cached value
+template<typename SymType>
+struct input_split
+{
+  static constexpr bool value = false;
+};
+
+template<class... Syms>
+struct input_split_of
+{
+  typedef decltype(InputIndices<false, Syms...>()) Independent;
+  typedef decltype(InputIndices<true, Syms...>()) Dependent;
+  static constexpr bool value =
+    (Independent::size() >= 2) && (Dependent::size() > 0)
+    && (false || ... || (Syms::is_dynamic && !depends_on_input_v<Syms>));
+};
+
+template<class... Syms>
+struct input_split<TupleSum<Syms...>> : input_split_of<Syms...>
+{};
+
+template<class... Syms>
+struct input_split<TupleProduct<Syms...>> : input_split_of<Syms...>
+{};
+
+
+template<typename SymType>
+struct hoisted_count;
+
+template<typename... Syms>
+constexpr std::size_t HoistedCountOf(type_list<Syms...>)
+{
+  return (std::size_t(0) + ... + hoisted_count<Syms>::value);
+}
+
+template<std::size_t... D, typename... Syms>
+constexpr std::size_t DependentHoistedCount(std::index_sequence<D...>, type_list<Syms...>)
+{
+  return (std::size_t(0) + ... + hoisted_count<NthTypeOf<D,Syms...>>::value);
+}
+
+template<typename SymType>
+struct hoisted_count
+{
+  static constexpr std::size_t compute()
+  {
+    if constexpr (is_hoistable_v<SymType>) {
+      return 1;
+    } else if constexpr (input_split<SymType>::value) {
+      return 1 + DependentHoistedCount(typename input_split<SymType>::Dependent(), node_children_t<SymType>());
+    } else {
+      return HoistedCountOf(node_children_t<SymType>());
+    }
+  }
+
+  static constexpr std::size_t value = compute();
+};
+
+template<typename SymType>
+constexpr std::size_t hoisted_count_v = hoisted_count<SymType>::value;
+
+// Index of the first hoisted subtree below the K-th of the children Is of a node
+template<std::size_t K, std::size_t... Is, typename... Syms>
+constexpr std::size_t HoistedOffset(std::index_sequence<Is...>, type_list<Syms...>)
+{
+  constexpr std::size_t counts[] = { hoisted_count_v<NthTypeOf<Is,Syms...>>..., 0 };
+  std::size_t offset = 0;
+  for (std::size_t i = 0; i < K; ++i) {
+    offset += counts[i];
+  }
+  return offset;
+}
+
+template<std::size_t K, typename... Syms>
+constexpr std::size_t HoistedOffset(type_list<Syms...> children)
+{
+  return HoistedOffset<K>(std::index_sequence_for<Syms...>(), children);
+}
+
+
+// expr with its K-th hoisted subtree replaced by a Reference to values[Offset + K]
+template<std::size_t Offset, typename T, typename SymType>
+constexpr auto Hoist(const SymbolicBase<SymType>& expr, const T* values)
+{
+  typedef node_children_t<SymType> ChildList;
+  if constexpr (is_hoistable_v<SymType>) {
+    return Reference<T>(values[Offset]);
+  }
+  else if constexpr (hoisted_count_v<SymType> == 0) {
+    return expr.derived();
+  }
+  else if constexpr (input_split<SymType>::value) {
+    // the independent terms become one leading cached term
+    typedef typename input_split<SymType>::Dependent Dependent;
+    const auto children = Children(expr);
+    return [&]<std::size_t... D>(std::index_sequence<D...> dependent) {
+      return [&]<std::size_t... K>(std::index_sequence<K...>) {
+        return RebuildImpl(expr.derived(), Reference<T>(values[Offset]),
+          Hoist<Offset + 1 + HoistedOffset<K>(dependent, ChildList())>(std::get<D>(children), values)...);
+      }(std::make_index_sequence<sizeof...(D)>());
+    }(Dependent());
+  }
+  else {
+    return [&]<std::size_t... K>(std::index_sequence<K...>) {
+      const auto children = Children(expr);
+      return Rebuild(expr,
+        Hoist<Offset + HoistedOffset<K>(ChildList())>(std::get<K>(children), values)...);
+    }(std::make_index_sequence<ChildList::size>());
+  }
+}
+
+// Evaluates every hoisted subtree of expr into values[Offset], values[Offset+1], ...
+template<std::size_t Offset, typename T, typename SymType>
+constexpr void StoreHoisted(const SymbolicBase<SymType>& expr, T* values)
+{
+  typedef node_children_t<SymType> ChildList;
+  if constexpr (is_hoistable_v<SymType>) {
+    values[Offset] = expr.Evaluate(static_cast<T>(0));
+  }
+  else if constexpr (input_split<SymType>::value) {
+    const auto children = Children(expr);
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      const T zero = static_cast<T>(0);
+      if constexpr (is_sum_v<SymType>) {
+        values[Offset] = (zero + ... + std::get<I>(children).Evaluate(zero));
+      } else {
+        values[Offset] = (static_cast<T>(1) * ... * std::get<I>(children).Evaluate(zero));
+      }
+    }(typename input_split<SymType>::Independent());
+    [&]<std::size_t... D>(std::index_sequence<D...> dependent) {
+      [&]<std::size_t... K>(std::index_sequence<K...>) {
+        (StoreHoisted<Offset + 1 + HoistedOffset<K>(dependent, ChildList())>(std::get<D>(children), values), ...);
+      }(std::make_index_sequence<sizeof...(D)>());
+    }(typename input_split<SymType>::Dependent());
+  }
+  else if constexpr (hoisted_count_v<SymType> > 0) {
+    [&]<std::size_t... K>(std::index_sequence<K...>) {
+      const auto children = Children(expr);
+      (StoreHoisted<Offset + HoistedOffset<K>(ChildList())>(std::get<K>(children), values), ...);
+    }(std::make_index_sequence<ChildList::size>());
+  }
+}
+
+
+template<typename SymType, typename T = double>
+class Bound;
+
+template<typename SymType>
+struct is_bound
+{
+  static constexpr bool value = false;
+};
+
+template<typename SymType, typename T>
+struct is_bound<Bound<SymType,T>>
+{
+  static constexpr bool value = true;
+};
+
+template<typename SymType>
+constexpr bool is_bound_v = is_bound<SymType>::value;
+
+
+// Addresses of the Reference leaves of a tree
+template<typename SymType>
+constexpr auto ReferenceAddresses(const SymbolicBase<SymType>& expr)
+{
+  if constexpr (node_kind_v<SymType> == NodeKind::Reference) {
+    return std::make_tuple(expr.derived().Address());
+  }
+  else if constexpr (is_interned_v<SymType>) {
+    return ReferenceAddresses(expr.derived().Node());
+  }
+  else if constexpr (is_bound_v<SymType>) {
+    return ReferenceAddresses(expr.derived().Expression());
+  }
+  else {
+    return std::apply(
+      [](const auto&... children) { return std::tuple_cat(std::tuple<>(), ReferenceAddresses(children)...); },
+      Children(expr));
+  }
+}
+
+// Addresses of the Reference leaves below the hoisted subtrees of a tree
+template<typename SymType>
+constexpr auto HoistedReferences(const SymbolicBase<SymType>& expr)
+{
+  if constexpr (is_hoistable_v<SymType>) {
+    return ReferenceAddresses(expr);
+  }
+  else if constexpr (hoisted_count_v<SymType> == 0) {
+    return std::tuple<>();
+  }
+  else if constexpr (input_split<SymType>::value) {
+    const auto children = Children(expr);
+    return std::tuple_cat(
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        return std::tuple_cat(std::tuple<>(), ReferenceAddresses(std::get<I>(children))...);
+      }(typename input_split<SymType>::Independent()),
+      [&]<std::size_t... D>(std::index_sequence<D...>) {
+        return std::tuple_cat(std::tuple<>(), HoistedReferences(std::get<D>(children))...);
+      }(typename input_split<SymType>::Dependent()));
+  }
+  else {
+    return std::apply(
+      [](const auto&... children) { return std::tuple_cat(std::tuple<>(), HoistedReferences(children)...); },
+      Children(expr));
+  }
+}
+
+template<class... Pointers>
+constexpr auto Dereference(const std::tuple<Pointers...>& addresses)
+{
+  return std::apply([](const auto*... address) { return std::make_tuple(*address...); }, addresses);
+}
+
+
+// BOUND
+// expr with every subtree that depends on runtime values but not on the input
+// (e.g. ln(k) * sqrt(a)) evaluated once and read back from a cache. The terms of
+// a sum or product that don't depend on the input share a single cached value. Call
+// Rebind() after changing a referenced value, or Refresh() to rebind only when
+// one of them has changed. Copies, moves and assignments rebind, since the tree
+// points into the cache.
+template<typename SymType, typename T>
+class Bound : public SymbolicBase< Bound<SymType,T> >
+{
+public:
+  static constexpr std::size_t size = hoisted_count_v<SymType>;
+
+private:
+  typedef decltype(Hoist<0>(std::declval<SymType>(), std::declval<const T*>())) TreeType;
+  typedef decltype(HoistedReferences(std::declval<SymType>())) AddressTuple;
+  typedef decltype(Dereference(std::declval<AddressTuple>())) ValueTuple;
+
+  SymType expr_;
+  std::array<T,size> values_;
+  AddressTuple addresses_;
+  ValueTuple snapshot_;
+  TreeType tree_;
+
+public:
+  static constexpr bool is_leaf = false;
+  static constexpr bool is_dynamic = true;
+
+  explicit Bound(const SymType& expr)
+    : expr_{expr}, values_{}, addresses_{HoistedReferences(expr_)},
+      snapshot_{Dereference(addresses_)}, tree_{Hoist<0>(expr_, values_.data())}
+  {
+    StoreHoisted<0>(expr_, values_.data());
+  }
+
+  Bound(const Bound& other) : Bound(other.expr_)
+  {}
+
+  Bound(Bound&& other) noexcept(std::is_nothrow_copy_constructible_v<SymType>)
+    : Bound(other.expr_)
+  {}
+
+  // Nodes may hold const members, so the whole Bound is rebuilt in place
+  Bound& operator=(const Bound& other)
+  {
+    if (this != &other) {
+      const SymType expr = other.expr_;
+      std::destroy_at(this);
+      std::construct_at(this, expr);
+    }
+    return *this;
+  }
+
+  Bound& operator=(Bound&& other) noexcept(std::is_nothrow_copy_constructible_v<SymType>)
+  {
+    return *this = static_cast<const Bound&>(other);
+  }
+
+  // Recomputes every cached subtree from the current referenced values
+  void Rebind()
+  {
+    snapshot_ = Dereference(addresses_);
+    StoreHoisted<0>(expr_, values_.data());
+  }
+
+  // Whether a value referenced by a cached subtree changed since the last bind
+  bool Stale() const
+  {
+    return Dereference(addresses_) != snapshot_;
+  }
+
+  void Refresh()
+  {
+    if (Stale()) {
+      Rebind();
+    }
+  }
+
+  template<typename FloatType>
+  constexpr FloatType Evaluate(const FloatType input) const
+  {
+    return tree_.Evaluate(input);
+  }
+
+  constexpr auto Derivative() const
+  {
+    return expr_.Derivative();
+  }
+
+  std::string str() const
+  {
+    return expr_.str();
+  }
+
+  // The original expression, and the one evaluated in its place
+  constexpr const SymType& Expression() const
+  {
+    return expr_;
+  }
+
+  constexpr const TreeType& Tree() const
+  {
+    return tree_;
+  }
+};
+
+// Measured and traversed as a leaf: its cache isn't part of any tree
+template<typename SymType, typename T>
+struct node_children<Bound<SymType,T>>
+{
+  typedef type_list<> type;
+};
+
+template<typename SymType, typename T>
+struct depends_on_input<Bound<SymType,T>>
+{
+  static constexpr bool value = depends_on_input_v<SymType>;
+};
+
+template<typename SymType, typename T>
+struct structural_hash<Bound<SymType,T>>
+{
+  static constexpr std::uint64_t value = HashCombine(KindHash(NodeKind::Unknown), structural_hash_v<SymType>);
+};
+
+// A bound expression hashes like the expression it evaluates
+template<typename SymType, typename T>
+std::uint64_t StructuralHash(const Bound<SymType,T>& expr)
+{
+  return HashCombine(structural_hash_v<Bound<SymType,T>>, StructuralHash(expr.Expression()));
+}
+
+
+template<typename T = double, typename SymType>
+Bound<SymType,T> Bind(const SymbolicBase<SymType>& expr)
+{
+  return Bound<SymType,T>(expr.derived());
+}
+
+
+} // Symbolic namespace
+#endif
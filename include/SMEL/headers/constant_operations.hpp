@@ -141,7 +141,7 @@ constexpr auto operator+(
   if constexpr (factor == den) {
     return Constant<ResultType,num/factor>();
   } else {
-    return IntegerFraction<ResultType,num/factor,ResultType,den/factor>();
+    return Fraction<ResultType,num/factor,den/factor>();
   }
 }
 
@@ -159,7 +159,7 @@ constexpr auto operator-(
   if constexpr (factor == den) {
     return Constant<ResultType,num/factor>();
   } else {
-    return IntegerFraction<ResultType,num/factor,ResultType,den/factor>();
+    return Fraction<ResultType,num/factor,den/factor>();
   }
 }
 
@@ -202,7 +202,7 @@ constexpr auto operator/(
   if constexpr (factor == den) {
     return Constant<ResultType,num/factor>();
   } else {
-    return IntegerFraction<ResultType,num/factor,ResultType,den/factor>();
+    return Fraction<ResultType,num/factor,den/factor>();
   }
 }
 
@@ -225,7 +225,7 @@ constexpr auto operator+(
     if constexpr (factor == den) {
       return Constant<ResultType,num/factor>();
     } else {
-      return IntegerFraction<ResultType,num/factor,ResultType,den/factor>();
+      return Fraction<ResultType,num/factor,den/factor>();
     }
   }
 }
@@ -248,7 +248,7 @@ constexpr auto operator+(
     if constexpr (factor == den) {
       return Constant<ResultType,num/factor>();
     } else {
-      return IntegerFraction<ResultType,num/factor,ResultType,den/factor>();
+      return Fraction<ResultType,num/factor,den/factor>();
     }
   }
 }
@@ -271,7 +271,7 @@ constexpr auto operator-(
     if constexpr (factor == den) {
       return Constant<ResultType,num/factor>();
     } else {
-      return IntegerFraction<ResultType,num/factor,ResultType,den/factor>();
+      return Fraction<ResultType,num/factor,den/factor>();
     }
   }
 }
@@ -317,7 +317,7 @@ constexpr auto operator*(
     if constexpr (factor == den) {
       return Constant<ResultType,num/factor>();
     } else {
-      return IntegerFraction<ResultType,num/factor,ResultType,den/factor>();
+      return Fraction<ResultType,num/factor,den/factor>();
     }
   }
 }
@@ -339,7 +339,7 @@ constexpr auto operator*(
     if constexpr (factor == den) {
       return Constant<ResultType,num/factor>();
     } else {
-      return IntegerFraction<ResultType,num/factor,ResultType,den/factor>();
+      return Fraction<ResultType,num/factor,den/factor>();
     }
   }
 }
@@ -361,7 +361,7 @@ constexpr auto operator/(
     if constexpr (factor == den) {
       return Constant<ResultType,num/factor>();
     } else {
-      return IntegerFraction<ResultType,num/factor,ResultType,den/factor>();
+      return Fraction<ResultType,num/factor,den/factor>();
     }
   }
 }
@@ -383,7 +383,7 @@ constexpr auto operator/(
     if constexpr (factor == den) {
       return Constant<ResultType,num/factor>();
     } else {
-      return IntegerFraction<ResultType,num/factor,ResultType,den/factor>();
+      return Fraction<ResultType,num/factor,den/factor>();
     }
   }
 }
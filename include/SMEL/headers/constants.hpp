@@ -180,7 +180,9 @@ private:
   const T& c_;
 
 public:
-  static constexpr bool is_leaf = true;
+  // Holds no more than a pointer, so parent nodes keep their own copy rather
+  // than a reference that would dangle once a temporary Reference is destroyed
+  static constexpr bool is_leaf = false;
   static constexpr bool is_dynamic = true;
 
   explicit constexpr Reference(const T& c) : c_{c}
@@ -196,6 +198,9 @@ public:
   std::string str() const
   { return std::to_string(c_); }
 
+  const T* Address() const
+  { return &c_; }
+
   template<typename Type>
   friend bool IsSame(const Reference<Type>&, const Reference<Type>&);
 };
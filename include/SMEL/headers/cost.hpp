@@ -0,0 +1,243 @@
+#ifndef SYMBOLIC_INCLUDE_COST_HPP
+#define SYMBOLIC_INCLUDE_COST_HPP
+
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+#include "metaprogramming.hpp"
+#include "prototyping.hpp"
+#include "type_deductions.hpp"
+#include "ordering.hpp"
+#include "structure.hpp"
+
+
+namespace SYMBOLIC_NAMESPACE_NAME {
+
+// Relative cost of each operation, roughly in cycles. Pass a struct with the
+// same members to eval_cost to use other weights. Negation, abs and sign count
+// as an add, the other trigonometric functions and their inverses as a sin,
+// reciprocal ones (sec, csc, cot, ...) as a sin and a div.
+struct CostWeights
+{
+  static constexpr double add = 1;
+  static constexpr double mul = 1;
+  static constexpr double div = 4;
+  static constexpr double sqrt = 4;
+  static constexpr double exp = 20;
+  static constexpr double log = 20;
+  static constexpr double sin = 20;
+  static constexpr double pow = 40;
+};
+
+
+// A handle is measured as the node it refers to
+template<typename SymType>
+struct cost_node
+{
+  typedef SymType type;
+};
+
+template<typename SymType>
+struct cost_node<Interned<SymType>>
+{
+  typedef SymType type;
+};
+
+template<typename SymType>
+using cost_node_t = typename cost_node<SymType>::type;
+
+
+// NODE COUNT
+template<typename SymType>
+struct node_count;
+
+template<typename... Syms>
+constexpr std::size_t NodeCountOf(type_list<Syms...>)
+{
+  return (std::size_t(0) + ... + node_count<Syms>::value);
+}
+
+template<typename SymType>
+struct node_count
+{
+  static constexpr std::size_t value = 1 + NodeCountOf(node_children_t<cost_node_t<SymType>>());
+};
+
+template<typename SymType>
+constexpr std::size_t node_count_v = node_count<SymType>::value;
+
+
+// DEPTH
+template<typename SymType>
+struct depth;
+
+template<typename... Syms>
+constexpr std::size_t DepthOf(type_list<Syms...>)
+{
+  return std::max({std::size_t(0), depth<Syms>::value...});
+}
+
+template<typename SymType>
+struct depth
+{
+  static constexpr std::size_t value = 1 + DepthOf(node_children_t<cost_node_t<SymType>>());
+};
+
+template<typename SymType>
+constexpr std::size_t depth_v = depth<SymType>::value;
+
+
+// DYNAMIC LEAF COUNT
+// Number of leaves whose value is only known at runtime
+template<typename SymType>
+struct dynamic_leaf_count;
+
+template<typename... Syms>
+constexpr std::size_t DynamicLeafCountOf(type_list<Syms...>)
+{
+  return (std::size_t(0) + ... + dynamic_leaf_count<Syms>::value);
+}
+
+template<typename SymType>
+struct dynamic_leaf_count
+{
+  typedef cost_node_t<SymType> Node;
+  static constexpr std::size_t value = (node_children_t<Node>::size == 0)
+    ? (Node::is_dynamic ? 1 : 0)
+    : DynamicLeafCountOf(node_children_t<Node>());
+};
+
+template<typename SymType>
+constexpr std::size_t dynamic_leaf_count_v = dynamic_leaf_count<SymType>::value;
+
+
+// EVAL COST
+// Weighted number of operations performed by Evaluate
+template<typename SymType, typename Weights = CostWeights>
+struct eval_cost;
+
+template<typename Weights, typename... Syms>
+constexpr double EvalCostOf(type_list<Syms...>)
+{
+  return (0.0 + ... + eval_cost<Syms,Weights>::value);
+}
+
+template<typename Weights, typename Base, typename Exponent>
+constexpr double ExponentialCost(type_list<Base,Exponent>)
+{
+  if constexpr (is_constant_e_v<Base>) {
+    return Weights::exp;
+  } else if constexpr (is_one_half_v<Exponent>) {
+    return Weights::sqrt;
+  } else {
+    return Weights::pow;
+  }
+}
+
+template<typename Weights, typename Base, typename SymType>
+constexpr double LogarithmCost(type_list<Base,SymType>)
+{
+  if constexpr (is_constant_e_v<Base>) {
+    return Weights::log;
+  } else {
+    return 2 * Weights::log + Weights::div;
+  }
+}
+
+// Cost of the node itself, excluding its children
+template<typename SymType, typename Weights>
+constexpr double NodeCost()
+{
+  constexpr NodeKind kind = node_kind_v<SymType>;
+  constexpr std::size_t n_children = node_children_t<SymType>::size;
+  if constexpr (kind == NodeKind::Sum) {
+    return (n_children - 1) * Weights::add;
+  }
+  else if constexpr (kind == NodeKind::Product) {
+    return (n_children - 1) * Weights::mul;
+  }
+  else if constexpr (kind == NodeKind::Quotient) {
+    return Weights::div;
+  }
+  else if constexpr (kind == NodeKind::Negation || kind == NodeKind::AbsoluteValue || kind == NodeKind::Signum) {
+    return Weights::add;
+  }
+  else if constexpr (kind == NodeKind::Exponential) {
+    return ExponentialCost<Weights>(node_children_t<SymType>());
+  }
+  else if constexpr (kind == NodeKind::Logarithm) {
+    return LogarithmCost<Weights>(node_children_t<SymType>());
+  }
+  else if constexpr (kind == NodeKind::Sine || kind == NodeKind::Cosine || kind == NodeKind::Tangent
+      || kind == NodeKind::ArcSine || kind == NodeKind::ArcCosine || kind == NodeKind::ArcTangent) {
+    return Weights::sin;
+  }
+  else if constexpr (kind == NodeKind::Secant || kind == NodeKind::Cosecant || kind == NodeKind::Cotangent
+      || kind == NodeKind::ArcSecant || kind == NodeKind::ArcCosecant || kind == NodeKind::ArcCotangent) {
+    return Weights::sin + Weights::div;
+  }
+  else {
+    return 0.0;
+  }
+}
+
+template<typename Weights, typename... Syms>
+constexpr double ProductDerivativeCost()
+{
+  constexpr std::size_t n = sizeof...(Syms);
+  constexpr std::size_t n_varying = (std::size_t(0) + ... + (is_zero_v<decltype(std::declval<Syms>().Derivative())> ? 0 : 1));
+  // prefix and suffix products, then f_i' * prefix * suffix summed over varying factors
+  return (2*n + 2*n_varying) * Weights::mul + n_varying * Weights::add
+    + (0.0 + ... + eval_cost<decltype(std::declval<Syms>().Derivative()), Weights>::value);
+}
+
+template<typename Weights, typename... Syms>
+constexpr double ProductDerivativeCost(type_list<Syms...>)
+{
+  return ProductDerivativeCost<Weights, Syms...>();
+}
+
+template<typename SymType, typename Weights>
+struct eval_cost
+{
+  typedef cost_node_t<SymType> Node;
+
+  static constexpr double compute()
+  {
+    if constexpr (node_kind_v<Node> == NodeKind::IntegerFraction) {
+      return 0.0;
+    } else if constexpr (is_product_derivative_v<Node>) {
+      return ProductDerivativeCost<Weights>(node_children_t<Node>()) + EvalCostOf<Weights>(node_children_t<Node>());
+    } else {
+      return NodeCost<Node,Weights>() + EvalCostOf<Weights>(node_children_t<Node>());
+    }
+  }
+
+  static constexpr double value = compute();
+};
+
+template<typename SymType, typename Weights = CostWeights>
+constexpr double eval_cost_v = eval_cost<SymType,Weights>::value;
+
+
+// Same traits from an expression object
+template<typename SymType>
+constexpr std::size_t NodeCount(const SymbolicBase<SymType>&)
+{ return node_count_v<SymType>; }
+
+template<typename SymType>
+constexpr std::size_t Depth(const SymbolicBase<SymType>&)
+{ return depth_v<SymType>; }
+
+template<typename SymType>
+constexpr std::size_t DynamicLeafCount(const SymbolicBase<SymType>&)
+{ return dynamic_leaf_count_v<SymType>; }
+
+template<typename Weights = CostWeights, typename SymType>
+constexpr double EvalCost(const SymbolicBase<SymType>&)
+{ return eval_cost_v<SymType,Weights>; }
+
+
+} // Symbolic namespace
+#endif
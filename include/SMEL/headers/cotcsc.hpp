@@ -25,29 +25,37 @@ template<typename SymType>
 class Cotangent : public SymbolicBase< Cotangent<SymType> >
 {
 private:
-  typename std::conditional_t<SymType::is_leaf, const SymType&, const SymType> expr_;
+  [[no_unique_address]] Branch<SymType> expr_;
 
 public:
   static constexpr bool is_leaf = false;
   static constexpr bool is_dynamic = SymType::is_dynamic;
 
+  constexpr Cotangent() = default;
+
   constexpr Cotangent(const SymType& expr) : expr_{expr}
   {}
 
   template<typename FloatType>
   FloatType Evaluate(const FloatType input) const
   {
-    return 1.0 / std::tan(expr_.Evaluate(input));
+    using std::tan;
+    return static_cast<FloatType>(1) / tan(expr_->Evaluate(input));
   }
 
   auto Derivative() const
   {
-    return pow<2>( Cosecant<SymType>(expr_) ) * (-expr_.Derivative());
+    return pow<2>( Cosecant<SymType>(*expr_) ) * (-expr_->Derivative());
   }
 
   std::string str() const
   {
-    return "cot(" + expr_.str() + ")";
+    return "cot(" + expr_->str() + ")";
+  }
+
+  constexpr auto Argument() const
+  {
+    return *expr_;
   }
 };
 
@@ -56,29 +64,37 @@ template<typename SymType>
 class Cosecant : public SymbolicBase< Cosecant<SymType> >
 {
 private:
-  typename std::conditional_t<SymType::is_leaf, const SymType&, const SymType> expr_;
+  [[no_unique_address]] Branch<SymType> expr_;
 
 public:
   static constexpr bool is_leaf = false;
   static constexpr bool is_dynamic = SymType::is_dynamic;
 
+  constexpr Cosecant() = default;
+
   constexpr Cosecant(const SymType& expr) : expr_{expr}
   {}
 
   template<typename FloatType>
   FloatType Evaluate(const FloatType input) const
   {
-    return 1.0 / std::sin(expr_.Evaluate(input));
+    using std::sin;
+    return static_cast<FloatType>(1) / sin(expr_->Evaluate(input));
   }
 
   auto Derivative() const
   {
-    return Cosecant<SymType>(expr_) * Cotangent<SymType>(expr_) * (-expr_.Derivative());
+    return Cosecant<SymType>(*expr_) * Cotangent<SymType>(*expr_) * (-expr_->Derivative());
   }
 
   std::string str() const
   {
-    return "csc(" + expr_.str() + ")";
+    return "csc(" + expr_->str() + ")";
+  }
+
+  constexpr auto Argument() const
+  {
+    return *expr_;
   }
 };
 
@@ -87,29 +103,37 @@ template<typename SymType>
 class ArcCotangent : public SymbolicBase< ArcCotangent<SymType> >
 {
 private:
-  typename std::conditional_t<SymType::is_leaf, const SymType&, const SymType> expr_;
+  [[no_unique_address]] Branch<SymType> expr_;
 
 public:
   static constexpr bool is_leaf = false;
   static constexpr bool is_dynamic = SymType::is_dynamic;
 
+  constexpr ArcCotangent() = default;
+
   constexpr ArcCotangent(const SymType& expr) : expr_{expr}
   {}
 
   template<typename FloatType>
   FloatType Evaluate(const FloatType input) const
   {
-    return std::atan(1.0 / expr_.Evaluate(input));
+    using std::atan;
+    return atan(static_cast<FloatType>(1) / expr_->Evaluate(input));
   }
 
   auto Derivative() const
   {
-    return -expr_.Derivative() / ( One<>() + pow<2>(expr_) );
+    return -expr_->Derivative() / ( One<>() + pow<2>(*expr_) );
   }
 
   std::string str() const
   {
-    return "arccot(" + expr_.str() + ")";
+    return "arccot(" + expr_->str() + ")";
+  }
+
+  constexpr auto Argument() const
+  {
+    return *expr_;
   }
 };
 
@@ -118,29 +142,37 @@ template<typename SymType>
 class ArcCosecant : public SymbolicBase< ArcCosecant<SymType> >
 {
 private:
-  typename std::conditional_t<SymType::is_leaf, const SymType&, const SymType> expr_;
+  [[no_unique_address]] Branch<SymType> expr_;
 
 public:
   static constexpr bool is_leaf = false;
   static constexpr bool is_dynamic = SymType::is_dynamic;
 
+  constexpr ArcCosecant() = default;
+
   constexpr ArcCosecant(const SymType& expr) : expr_{expr}
   {}
 
   template<typename FloatType>
   FloatType Evaluate(const FloatType input) const
   {
-    return std::asin(1.0 / expr_.Evaluate(input));
+    using std::asin;
+    return asin(static_cast<FloatType>(1) / expr_->Evaluate(input));
   }
 
   auto Derivative() const
   {
-    return -expr_.Derivative() / ( abs(expr_) * sqrt((expr_ ^ Int<2>()) - One<>()) );
+    return -expr_->Derivative() / ( abs(*expr_) * sqrt((*expr_ ^ Int<2>()) - One<>()) );
   }
 
   std::string str() const
   {
-    return "arccsc(" + expr_.str() + ")";
+    return "arccsc(" + expr_->str() + ")";
+  }
+
+  constexpr auto Argument() const
+  {
+    return *expr_;
   }
 };
 
@@ -148,25 +180,25 @@ public:
 template<typename SymType>
 auto cot(const SymbolicBase<SymType>& expr)
 {
-  return Cotangent<SymType>(expr.derived());
+  return ApplyConstructionRules(Cotangent<SymType>(expr.derived()));
 }
 
 template<typename SymType>
 auto csc(const SymbolicBase<SymType>& expr)
 {
-  return Cosecant<SymType>(expr.derived());
+  return ApplyConstructionRules(Cosecant<SymType>(expr.derived()));
 }
 
 template<typename SymType>
 auto arccot(const SymbolicBase<SymType>& expr)
 {
-  return ArcCotangent<SymType>(expr.derived());
+  return ApplyConstructionRules(ArcCotangent<SymType>(expr.derived()));
 }
 
 template<typename SymType>
 auto arccsc(const SymbolicBase<SymType>& expr)
 {
-  return ArcCosecant<SymType>(expr.derived());
+  return ApplyConstructionRules(ArcCosecant<SymType>(expr.derived()));
 }
 
 
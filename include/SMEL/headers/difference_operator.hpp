@@ -9,19 +9,29 @@
 
 namespace SYMBOLIC_NAMESPACE_NAME {
 
+// Subtracts a sum one element at a time so each can cancel against a like term
+template<class SymType, class... Syms, std::size_t... I>
+constexpr auto SubtractTerms(const SymbolicBase<SymType>& expr, const TupleSum<Syms...>& sum, const std::index_sequence<I...>)
+{
+  return (expr.derived() + ... + (-get<I>(sum)));
+}
+
 template<typename Sym1, typename Sym2>
 constexpr auto
 operator-(const SymbolicBase<Sym1>& expr1, const SymbolicBase<Sym2>& expr2)
 {
   if constexpr (is_zero_v<Sym1>) {
-    return expr2.derived();
+    return -expr2.derived();
   }
   else if constexpr (is_zero_v<Sym2>) {
-    return -expr1.derived();
+    return expr1.derived();
   }
   else if constexpr (is_same_v<Sym1,Sym2>) {
     return Zero<>();
   }
+  else if constexpr (is_sum_v<Sym2>) {
+    return SubtractTerms(expr1, expr2.derived(), std::make_index_sequence<Sym2::size>());
+  }
   else {
     return expr1.derived() + (-expr2.derived());
   }
@@ -0,0 +1,118 @@
+#ifndef SYMBOLIC_INCLUDE_HASH_HPP
+#define SYMBOLIC_INCLUDE_HASH_HPP
+
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+#include "metaprogramming.hpp"
+#include "symbolic_base.hpp"
+#include "prototyping.hpp"
+#include "constants.hpp"
+#include "ordering.hpp"
+
+
+namespace SYMBOLIC_NAMESPACE_NAME {
+
+// splitmix64 finalizer
+constexpr std::uint64_t HashMix(std::uint64_t h)
+{
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ull;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebull;
+  h ^= h >> 31;
+  return h;
+}
+
+// Order-sensitive combination of seed with value
+constexpr std::uint64_t HashCombine(const std::uint64_t seed, const std::uint64_t value)
+{
+  return HashMix(seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2)));
+}
+
+constexpr std::uint64_t KindHash(const NodeKind kind)
+{
+  return HashMix(static_cast<std::uint64_t>(kind) + 1);
+}
+
+// Distinguishes the value types of constants and dynamic leaves
+template<typename T>
+constexpr std::uint64_t ValueTypeHash()
+{
+  return HashMix((std::uint64_t(sizeof(T)) << 2)
+    | (std::uint64_t(std::is_floating_point_v<T>) << 1)
+    | std::uint64_t(std::is_signed_v<T>));
+}
+
+template<typename T>
+constexpr std::uint64_t ValueBits(const T value)
+{
+  if constexpr (std::is_floating_point_v<T>) {
+    return std::bit_cast<std::uint64_t>(static_cast<double>(value));
+  } else {
+    return static_cast<std::uint64_t>(value);
+  }
+}
+
+
+// STRUCTURAL HASH
+// 64-bit hash of an expression type, computed once per type. Equal expressions
+// hash equally, and sums and products hash the same whatever the order of their
+// elements, so a hash mismatch rules out equality without visiting the trees.
+// Dynamic leaves hash by kind and value type only; see StructuralHash for a
+// hash of their runtime values.
+template<typename SymType>
+struct structural_hash;
+
+template<typename SymType>
+constexpr std::uint64_t structural_hash_v = structural_hash<SymType>::value;
+
+template<bool Commutative, typename... Syms>
+constexpr std::uint64_t ChildrenHash(const std::uint64_t seed, type_list<Syms...>)
+{
+  if constexpr (Commutative) {
+    const std::uint64_t sum = (std::uint64_t(0) + ... + HashMix(structural_hash_v<Syms>));
+    return HashCombine(HashCombine(seed, sizeof...(Syms)), sum);
+  } else {
+    std::uint64_t h = seed;
+    ((h = HashCombine(h, structural_hash_v<Syms>)), ...);
+    return h;
+  }
+}
+
+template<typename SymType>
+struct structural_hash
+{
+  static constexpr NodeKind kind = node_kind_v<SymType>;
+  static constexpr std::uint64_t value = ChildrenHash<kind == NodeKind::Sum || kind == NodeKind::Product>(
+    KindHash(kind), node_children_t<SymType>());
+};
+
+template<typename T, T Val>
+struct structural_hash<Constant<T,Val>>
+{
+  static constexpr std::uint64_t value =
+    HashCombine(HashCombine(KindHash(NodeKind::Constant), ValueTypeHash<T>()), ValueBits(Val));
+};
+
+template<typename T>
+struct structural_hash<RuntimeConstant<T>>
+{
+  static constexpr std::uint64_t value = HashCombine(KindHash(NodeKind::RuntimeConstant), ValueTypeHash<T>());
+};
+
+template<typename T>
+struct structural_hash<Reference<T>>
+{
+  static constexpr std::uint64_t value = HashCombine(KindHash(NodeKind::Reference), ValueTypeHash<T>());
+};
+
+
+// Whether two expression types may be equal: false means they are not
+template<typename Sym1, typename Sym2>
+constexpr bool hash_match_v = (structural_hash_v<Sym1> == structural_hash_v<Sym2>);
+
+
+} // Symbolic namespace
+#endif
@@ -0,0 +1,240 @@
+#ifndef SYMBOLIC_INCLUDE_INCREMENTAL_HPP
+#define SYMBOLIC_INCLUDE_INCREMENTAL_HPP
+
+#include <span>
+#include <array>
+#include <tuple>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include "symbolic_base.hpp"
+#include "prototyping.hpp"
+#include "constants.hpp"
+#include "ordering.hpp"
+#include "structure.hpp"
+#include "bind.hpp"
+
+
+namespace SYMBOLIC_NAMESPACE_NAME {
+
+// Number of Reference leaves of a tree, looking through handles and bound expressions
+template<typename SymType>
+constexpr std::size_t reference_leaf_count_v =
+  std::tuple_size_v<decltype(ReferenceAddresses(std::declval<SymType>()))>;
+
+// A node is split into its children when some of them hold parameters. Other
+// nodes are cached whole: static or parameter-free subtrees, leaves, handles,
+// and ProductDerivative, which evaluates the derivatives of its factors.
+template<typename SymType>
+constexpr bool is_split_node_v =
+  (reference_leaf_count_v<SymType> > 0)
+  && (node_children_t<SymType>::size > 0)
+  && !is_product_derivative_v<SymType>;
+
+// Children substituted by their cached values when their parent is recomputed.
+// Compile-time constants stay in place, a Logarithm needs its base static.
+template<typename SymType>
+constexpr bool is_cached_child_v = SymType::is_dynamic || depends_on_input_v<SymType>;
+
+template<typename SymType>
+struct cache_unit_count;
+
+template<typename... Syms>
+constexpr std::size_t CacheUnitCountOf(type_list<Syms...>)
+{
+  return (std::size_t(0) + ... + cache_unit_count<Syms>::value);
+}
+
+template<typename SymType>
+struct cache_unit_count
+{
+  static constexpr std::size_t value = is_split_node_v<SymType> ? 1 + CacheUnitCountOf(node_children_t<SymType>()) : 1;
+};
+
+// Unit index of child K of a node at unit index 0
+template<std::size_t K, typename... Syms>
+constexpr std::size_t ChildUnitOffset(type_list<Syms...>)
+{
+  constexpr std::size_t counts[] = { cache_unit_count<Syms>::value..., 0 };
+  std::size_t offset = 1;
+  for (std::size_t i = 0; i < K; ++i) {
+    offset += counts[i];
+  }
+  return offset;
+}
+
+
+// INCREMENTAL EVALUATION
+// Values of expr over a fixed set of inputs, cached per subtree. Each cached
+// subtree records which Reference parameters it depends on; Evaluate compares
+// the parameters against their values at the previous call and recomputes only
+// the subtrees below a parameter that changed. Subtrees that depend on the input
+// keep one value per input, the others a single value, so memory is bounded by
+// (number of nodes on paths to a parameter + their other children) * inputs.
+template<typename SymType, typename T = double>
+class Cached
+{
+public:
+  static constexpr std::size_t units = cache_unit_count<SymType>::value;
+  static constexpr std::size_t max_parameters = 64;
+  static_assert(reference_leaf_count_v<SymType> <= max_parameters,
+    "Cached tracks at most 64 Reference leaves");
+
+private:
+  typedef std::uint64_t Mask;
+  typedef T (*Reader)(const void*);
+
+  SymType expr_;
+  std::vector<T> inputs_;
+
+  // distinct parameters, the function reading each one and its last value
+  std::vector<const void*> parameters_;
+  std::vector<Reader> readers_;
+  std::vector<T> snapshot_;
+
+  std::array<Mask, units> masks_{};
+  std::array<std::vector<T>, units> values_;
+  bool valid_ = false;
+  std::size_t recomputed_ = 0;
+
+  template<typename U>
+  Mask ParameterMask(const U* address)
+  {
+    const auto it = std::find(parameters_.begin(), parameters_.end(), static_cast<const void*>(address));
+    if (it != parameters_.end()) {
+      return Mask(1) << (it - parameters_.begin());
+    }
+    parameters_.push_back(address);
+    readers_.push_back([](const void* p) { return static_cast<T>(*static_cast<const U*>(p)); });
+    snapshot_.push_back(static_cast<T>(*address));
+    return Mask(1) << (parameters_.size() - 1);
+  }
+
+  template<std::size_t Index, typename NodeType>
+  Mask Initialize(const NodeType& node)
+  {
+    values_[Index].resize((Index == 0 || depends_on_input_v<NodeType>) ? inputs_.size() : 1);
+    if constexpr (is_split_node_v<NodeType>) {
+      const auto children = Children(node);
+      masks_[Index] = [&]<std::size_t... K>(std::index_sequence<K...>) {
+        return (Mask(0) | ... |
+          Initialize<Index + ChildUnitOffset<K>(node_children_t<NodeType>())>(std::get<K>(children)));
+      }(std::make_index_sequence<node_children_t<NodeType>::size>());
+    } else {
+      masks_[Index] = std::apply(
+        [&](const auto*... address) { return (Mask(0) | ... | ParameterMask(address)); },
+        ReferenceAddresses(node));
+    }
+    return masks_[Index];
+  }
+
+  template<std::size_t Index, typename NodeType>
+  void Update(const NodeType& node, const Mask changed)
+  {
+    if constexpr (is_split_node_v<NodeType>) {
+      if (valid_ && !(masks_[Index] & changed)) {
+        return;
+      }
+      typedef node_children_t<NodeType> ChildList;
+      const auto children = Children(node);
+      [&]<std::size_t... K>(std::index_sequence<K...>) {
+        (Update<Index + ChildUnitOffset<K>(ChildList())>(std::get<K>(children), changed), ...);
+      }(std::make_index_sequence<ChildList::size>());
+
+      // The node over references to one value of each child, set per input
+      std::array<T, ChildList::size> slots{};
+      const auto op = [&]<std::size_t... K>(std::index_sequence<K...>) {
+        return RebuildImpl(node, [&]() {
+          if constexpr (is_cached_child_v<std::decay_t<decltype(std::get<K>(children))>>) {
+            return Reference<T>(slots[K]);
+          } else {
+            return std::get<K>(children);
+          }
+        }()...);
+      }(std::make_index_sequence<ChildList::size>());
+
+      std::vector<T>& values = values_[Index];
+      for (std::size_t i = 0; i < values.size(); ++i) {
+        [&]<std::size_t... K>(std::index_sequence<K...>) {
+          ((slots[K] = ChildValue<Index + ChildUnitOffset<K>(ChildList())>(i)), ...);
+        }(std::make_index_sequence<ChildList::size>());
+        values[i] = op.Evaluate(inputs_[i]);
+      }
+    }
+    else {
+      if (valid_ && !(masks_[Index] & changed)) {
+        return;
+      }
+      std::vector<T>& values = values_[Index];
+      if constexpr (depends_on_input_v<NodeType>) {
+        for (std::size_t i = 0; i < values.size(); ++i) {
+          values[i] = node.Evaluate(inputs_[i]);
+        }
+      } else {
+        std::fill(values.begin(), values.end(), node.Evaluate(static_cast<T>(0)));
+      }
+    }
+    ++recomputed_;
+  }
+
+  template<std::size_t Index>
+  T ChildValue(const std::size_t i) const
+  {
+    const std::vector<T>& values = values_[Index];
+    return values.size() == 1 ? values[0] : values[i];
+  }
+
+public:
+  Cached(const SymType& expr, const std::span<const T> inputs)
+    : expr_{expr}, inputs_(inputs.begin(), inputs.end())
+  {
+    Initialize<0>(expr_);
+  }
+
+  // Values of the expression at every input
+  const std::vector<T>& Evaluate()
+  {
+    Mask changed = 0;
+    for (std::size_t p = 0; p < parameters_.size(); ++p) {
+      const T value = readers_[p](parameters_[p]);
+      if (value != snapshot_[p]) {
+        snapshot_[p] = value;
+        changed |= Mask(1) << p;
+      }
+    }
+    recomputed_ = 0;
+    Update<0>(expr_, changed);
+    valid_ = true;
+    return values_[0];
+  }
+
+  // Forces the next Evaluate to recompute every subtree
+  void Invalidate()
+  { valid_ = false; }
+
+  const std::vector<T>& Inputs() const
+  { return inputs_; }
+
+  // Number of distinct Reference parameters
+  std::size_t Parameters() const
+  { return parameters_.size(); }
+
+  // Number of cached subtrees recomputed by the last Evaluate
+  std::size_t Recomputed() const
+  { return recomputed_; }
+};
+
+
+template<typename T = double, typename SymType>
+Cached<SymType,T> Cache(const SymbolicBase<SymType>& expr, const std::span<const T> inputs)
+{
+  return Cached<SymType,T>(expr.derived(), inputs);
+}
+
+
+} // Symbolic namespace
+#endif
@@ -0,0 +1,291 @@
+#ifndef SYMBOLIC_INCLUDE_INTERN_HPP
+#define SYMBOLIC_INCLUDE_INTERN_HPP
+
+#include <array>
+#include <tuple>
+#include <memory>
+#include <string>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <typeindex>
+#include <unordered_map>
+
+#include "symbolic_base.hpp"
+#include "constants.hpp"
+#include "ordering.hpp"
+#include "hash.hpp"
+#include "structure.hpp"
+
+
+namespace SYMBOLIC_NAMESPACE_NAME {
+
+// Handle to a node owned by a NodeTable. Copying it copies a pointer instead of
+// the subtree; the table must outlive every expression built from its handles.
+template<typename SymType>
+class Interned : public SymbolicBase< Interned<SymType> >
+{
+private:
+  const SymType* node_;
+
+public:
+  static constexpr bool is_leaf = false;
+  static constexpr bool is_dynamic = SymType::is_dynamic;
+
+  explicit constexpr Interned(const SymType* node) : node_{node}
+  {}
+
+  template<typename FloatType>
+  constexpr FloatType Evaluate(const FloatType input) const
+  {
+    return node_->Evaluate(input);
+  }
+
+  constexpr auto Derivative() const
+  {
+    return node_->Derivative();
+  }
+
+  std::string str() const
+  {
+    return node_->str();
+  }
+
+  constexpr const SymType& Node() const
+  {
+    return *node_;
+  }
+};
+
+// A handle is opaque to Children/Rebuild: its node is already interned
+template<typename SymType>
+struct node_children<Interned<SymType>>
+{
+  typedef type_list<> type;
+};
+
+template<typename SymType>
+struct is_interned
+{
+  static constexpr bool value = false;
+};
+
+template<typename SymType>
+struct is_interned<Interned<SymType>>
+{
+  static constexpr bool value = true;
+};
+
+template<typename SymType>
+constexpr bool is_interned_v = is_interned<SymType>::value;
+
+template<typename SymType>
+struct structural_hash<Interned<SymType>>
+{
+  static constexpr std::uint64_t value = HashCombine(KindHash(NodeKind::Unknown), structural_hash_v<SymType>);
+};
+
+
+// RUNTIME STRUCTURAL HASH
+// structural_hash_v extended with the values of dynamic leaves: the bits of
+// runtime constants and the addresses of references and interned nodes. Equal
+// trees hash equally, so this is the interning key, checked by InternKey.
+template<typename SymType>
+std::uint64_t StructuralHash(const SymbolicBase<SymType>& expr);
+
+template<typename SymType>
+std::uint64_t StructuralHash(const Interned<SymType>& expr)
+{
+  return HashCombine(structural_hash_v<Interned<SymType>>, reinterpret_cast<std::uintptr_t>(&expr.Node()));
+}
+
+template<typename T>
+std::uint64_t StructuralHash(const RuntimeConstant<T>& expr)
+{
+  std::uint64_t bits = 0;
+  const auto bytes = std::bit_cast<std::array<unsigned char, sizeof(T)>>(expr.Value());
+  for (const unsigned char byte : bytes) {
+    bits = HashCombine(bits, byte);
+  }
+  return HashCombine(structural_hash_v<RuntimeConstant<T>>, bits);
+}
+
+template<typename T>
+std::uint64_t StructuralHash(const Reference<T>& expr)
+{
+  return HashCombine(structural_hash_v<Reference<T>>, reinterpret_cast<std::uintptr_t>(expr.Address()));
+}
+
+template<typename SymType>
+std::uint64_t StructuralHash(const SymbolicBase<SymType>& expr)
+{
+  if constexpr (!SymType::is_dynamic) {
+    return structural_hash_v<SymType>;
+  }
+  else {
+    constexpr NodeKind kind = node_kind_v<SymType>;
+    const std::uint64_t seed = KindHash(kind);
+    return std::apply([&](const auto&... children) {
+      if constexpr (kind == NodeKind::Sum || kind == NodeKind::Product) {
+        const std::uint64_t sum = (std::uint64_t(0) + ... + HashMix(StructuralHash(children)));
+        return HashCombine(HashCombine(seed, sizeof...(children)), sum);
+      } else {
+        std::uint64_t h = seed;
+        ((h = HashCombine(h, StructuralHash(children))), ...);
+        return h;
+      }
+    }, Children(expr));
+  }
+}
+
+
+// INTERN KEY
+// Two nodes of the same type are identical when their keys compare equal. Once
+// children are interned a composite node is identified by its child pointers;
+// static subtrees are identified by their type alone.
+template<typename SymType>
+auto InternKey(const SymbolicBase<SymType>& expr);
+
+template<typename SymType>
+const void* InternKey(const Interned<SymType>& expr)
+{
+  return &expr.Node();
+}
+
+template<typename T>
+auto InternKey(const RuntimeConstant<T>& expr)
+{
+  return std::bit_cast<std::array<unsigned char, sizeof(T)>>(expr.Value());
+}
+
+template<typename T>
+const void* InternKey(const Reference<T>& expr)
+{
+  return expr.Address();
+}
+
+template<typename SymType>
+auto InternKey(const SymbolicBase<SymType>& expr)
+{
+  if constexpr (!SymType::is_dynamic) {
+    return std::tuple<>();
+  } else {
+    return std::apply(
+      [](const auto&... children) { return std::make_tuple(InternKey(children)...); },
+      Children(expr));
+  }
+}
+
+
+// Owns one copy of every distinct dynamic subtree passed to Intern. Insertion
+// is not thread-safe, evaluating interned expressions is.
+class NodeTable
+{
+private:
+  struct BucketBase
+  {
+    virtual ~BucketBase() = default;
+  };
+
+  // Nodes of one type by StructuralHash; InternKey settles collisions
+  template<typename SymType>
+  struct Bucket : public BucketBase
+  {
+    std::unordered_multimap<std::uint64_t, std::unique_ptr<const SymType>> nodes;
+  };
+
+  std::unordered_map<std::type_index, std::unique_ptr<BucketBase>> buckets_;
+  std::size_t requested_ = 0;
+  std::size_t stored_ = 0;
+  std::size_t bytes_requested_ = 0;
+  std::size_t bytes_stored_ = 0;
+
+public:
+  NodeTable() = default;
+  NodeTable(const NodeTable&) = delete;
+  NodeTable& operator=(const NodeTable&) = delete;
+
+  // Returns the stored node identical to node, storing a copy if there is none
+  template<typename SymType>
+  const SymType* Insert(const SymType& node)
+  {
+    typedef Bucket<SymType> BucketType;
+
+    std::unique_ptr<BucketBase>& bucket = buckets_[std::type_index(typeid(SymType))];
+    if (!bucket) {
+      bucket = std::make_unique<BucketType>();
+    }
+    auto& nodes = static_cast<BucketType&>(*bucket).nodes;
+
+    ++requested_;
+    const std::uint64_t hash = StructuralHash(node);
+    const auto [first, last] = nodes.equal_range(hash);
+    for (auto it = first; it != last; ++it) {
+      if (InternKey(*it->second) == InternKey(node)) {
+        return it->second.get();
+      }
+    }
+    ++stored_;
+    bytes_stored_ += sizeof(SymType);
+    return nodes.emplace(hash, std::make_unique<const SymType>(node))->second.get();
+  }
+
+  void AddRequestedBytes(const std::size_t bytes)
+  { bytes_requested_ += bytes; }
+
+  // Number of dynamic nodes passed in, and how many distinct ones are kept
+  std::size_t Requested() const
+  { return requested_; }
+
+  std::size_t Size() const
+  { return stored_; }
+
+  // sizeof every expression passed to Intern, against the bytes held by the
+  // table. Handles returned to the caller (one pointer each) are not included.
+  std::size_t BytesRequested() const
+  { return bytes_requested_; }
+
+  std::size_t BytesStored() const
+  { return bytes_stored_; }
+
+  std::ptrdiff_t BytesSaved() const
+  {
+    return static_cast<std::ptrdiff_t>(bytes_requested_) - static_cast<std::ptrdiff_t>(bytes_stored_);
+  }
+
+  std::string Report() const
+  {
+    return std::to_string(stored_) + " of " + std::to_string(requested_) + " nodes stored, "
+      + std::to_string(bytes_stored_) + " of " + std::to_string(bytes_requested_) + " bytes, "
+      + std::to_string(BytesSaved()) + " bytes saved";
+  }
+};
+
+
+template<typename SymType>
+constexpr auto InternNode(const SymbolicBase<SymType>& expr, NodeTable& table)
+{
+  if constexpr (!SymType::is_dynamic || is_interned_v<SymType>) {
+    return expr.derived();
+  } else {
+    const auto node = std::apply(
+      [&](const auto&... children) { return Rebuild(expr, InternNode(children, table)...); },
+      Children(expr));
+    return Interned(table.Insert(node));
+  }
+}
+
+// Opt-in shared storage: every dynamic subtree of expr is replaced by a handle
+// to a single copy in table, so identical subtrees (e.g. repeated runtime
+// constants, or the copies made by Derivative) are stored once. Static
+// subtrees are empty types and are kept by value.
+template<typename SymType>
+auto Intern(const SymbolicBase<SymType>& expr, NodeTable& table)
+{
+  table.AddRequestedBytes(sizeof(SymType));
+  return InternNode(expr, table);
+}
+
+
+} // Symbolic namespace
+#endif
@@ -0,0 +1,327 @@
+#ifndef SYMBOLIC_INCLUDE_INTERVAL_HPP
+#define SYMBOLIC_INCLUDE_INTERVAL_HPP
+
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <ostream>
+#include <concepts>
+#include <algorithm>
+
+#include "symbolic_base.hpp"
+
+
+namespace SYMBOLIC_NAMESPACE_NAME {
+
+/*
+  Closed interval [lo,hi] usable as the FloatType of any Evaluate call, giving
+  a guaranteed enclosure of the expression over the input interval.
+
+  Rounding is directed outward by stepping every computed bound one ulp away
+  from the enclosed range. This is slightly wider than switching the FPU
+  rounding mode, but doesn't depend on -frounding-math and also covers the
+  (sub-ulp) error of the libm transcendental functions.
+*/
+template<std::floating_point T>
+class Interval
+{
+private:
+  T lo_;
+  T hi_;
+
+  static constexpr T inf = std::numeric_limits<T>::infinity();
+
+public:
+  constexpr Interval() : lo_{0}, hi_{0}
+  {}
+
+  template<typename U> requires std::is_arithmetic_v<U>
+  explicit constexpr Interval(const U value)
+    : lo_{static_cast<T>(value)}, hi_{static_cast<T>(value)}
+  {
+    // Wide integers may not be exactly representable
+    if constexpr (std::integral<U>) {
+      if (static_cast<U>(lo_) != value) {
+        lo_ = RoundDown(lo_);
+        hi_ = RoundUp(hi_);
+      }
+    }
+  }
+
+  constexpr Interval(const T lo, const T hi) : lo_{lo}, hi_{hi}
+  {}
+
+  static constexpr Interval Entire()
+  { return Interval(-inf, inf); }
+
+  static constexpr T RoundDown(const T x)
+  { return (std::isinf(x) || std::isnan(x)) ? x : std::nextafter(x, -inf); }
+
+  static constexpr T RoundUp(const T x)
+  { return (std::isinf(x) || std::isnan(x)) ? x : std::nextafter(x, inf); }
+
+  // Bounds computed in round-to-nearest, widened by one ulp each way
+  static constexpr Interval Outward(const T lo, const T hi)
+  { return Interval(RoundDown(lo), RoundUp(hi)); }
+
+  constexpr T Lower() const
+  { return lo_; }
+
+  constexpr T Upper() const
+  { return hi_; }
+
+  constexpr T Width() const
+  { return hi_ - lo_; }
+
+  constexpr T Midpoint() const
+  { return lo_ + (hi_ - lo_) / static_cast<T>(2); }
+
+  constexpr bool Contains(const T x) const
+  { return (lo_ <= x) && (x <= hi_); }
+
+  constexpr bool IsPoint() const
+  { return lo_ == hi_; }
+
+  constexpr Interval operator-() const
+  { return Interval(-hi_, -lo_); }
+
+  constexpr Interval& operator+=(const Interval& other)
+  { return *this = *this + other; }
+
+  constexpr Interval& operator-=(const Interval& other)
+  { return *this = *this - other; }
+
+  constexpr Interval& operator*=(const Interval& other)
+  { return *this = *this * other; }
+
+  constexpr Interval& operator/=(const Interval& other)
+  { return *this = *this / other; }
+
+  friend constexpr Interval operator+(const Interval& a, const Interval& b)
+  { return Outward(a.lo_ + b.lo_, a.hi_ + b.hi_); }
+
+  friend constexpr Interval operator-(const Interval& a, const Interval& b)
+  { return Outward(a.lo_ - b.hi_, a.hi_ - b.lo_); }
+
+  friend constexpr Interval operator*(const Interval& a, const Interval& b)
+  {
+    // 0 * inf is taken as 0, the limit of the enclosed products
+    auto mul = [](const T x, const T y) {
+      return ((x == static_cast<T>(0)) || (y == static_cast<T>(0))) ? static_cast<T>(0) : x * y;
+    };
+    const T p1 = mul(a.lo_, b.lo_);
+    const T p2 = mul(a.lo_, b.hi_);
+    const T p3 = mul(a.hi_, b.lo_);
+    const T p4 = mul(a.hi_, b.hi_);
+    return Outward(std::min({p1,p2,p3,p4}), std::max({p1,p2,p3,p4}));
+  }
+
+  friend constexpr Interval operator/(const Interval& a, const Interval& b)
+  { return a * Reciprocal(b); }
+
+  // Reciprocal of a denominator that may span zero returns the hull of both branches
+  friend constexpr Interval Reciprocal(const Interval& b)
+  {
+    constexpr T zero = static_cast<T>(0);
+    constexpr T one = static_cast<T>(1);
+    if ((b.lo_ > zero) || (b.hi_ < zero)) {
+      return Outward(one / b.hi_, one / b.lo_);
+    }
+    else if ((b.lo_ == zero) && (b.hi_ > zero)) {
+      return Interval(RoundDown(one / b.hi_), inf);
+    }
+    else if ((b.lo_ < zero) && (b.hi_ == zero)) {
+      return Interval(-inf, RoundUp(one / b.lo_));
+    }
+    else {
+      return Entire();
+    }
+  }
+
+  friend constexpr bool operator==(const Interval& a, const Interval& b)
+  { return (a.lo_ == b.lo_) && (a.hi_ == b.hi_); }
+
+  friend std::ostream& operator<<(std::ostream& os, const Interval& x)
+  { return os << '[' << x.lo_ << ", " << x.hi_ << ']'; }
+};
+
+
+// Mixed scalar/interval arithmetic
+template<std::floating_point T, typename U> requires std::is_arithmetic_v<U>
+constexpr Interval<T> operator+(const Interval<T>& a, const U b)
+{ return a + Interval<T>(b); }
+
+template<std::floating_point T, typename U> requires std::is_arithmetic_v<U>
+constexpr Interval<T> operator+(const U a, const Interval<T>& b)
+{ return Interval<T>(a) + b; }
+
+template<std::floating_point T, typename U> requires std::is_arithmetic_v<U>
+constexpr Interval<T> operator-(const Interval<T>& a, const U b)
+{ return a - Interval<T>(b); }
+
+template<std::floating_point T, typename U> requires std::is_arithmetic_v<U>
+constexpr Interval<T> operator-(const U a, const Interval<T>& b)
+{ return Interval<T>(a) - b; }
+
+template<std::floating_point T, typename U> requires std::is_arithmetic_v<U>
+constexpr Interval<T> operator*(const Interval<T>& a, const U b)
+{ return a * Interval<T>(b); }
+
+template<std::floating_point T, typename U> requires std::is_arithmetic_v<U>
+constexpr Interval<T> operator*(const U a, const Interval<T>& b)
+{ return Interval<T>(a) * b; }
+
+template<std::floating_point T, typename U> requires std::is_arithmetic_v<U>
+constexpr Interval<T> operator/(const Interval<T>& a, const U b)
+{ return a / Interval<T>(b); }
+
+template<std::floating_point T, typename U> requires std::is_arithmetic_v<U>
+constexpr Interval<T> operator/(const U a, const Interval<T>& b)
+{ return Interval<T>(a) / b; }
+
+
+// ------------------- Elementary functions -------------------
+template<std::floating_point T>
+Interval<T> abs(const Interval<T>& x)
+{
+  if (x.Lower() >= static_cast<T>(0)) {
+    return x;
+  }
+  else if (x.Upper() <= static_cast<T>(0)) {
+    return -x;
+  }
+  else {
+    return Interval<T>(static_cast<T>(0), std::max(-x.Lower(), x.Upper()));
+  }
+}
+
+template<std::floating_point T>
+Interval<T> exp(const Interval<T>& x)
+{
+  return Interval<T>(
+    std::max(Interval<T>::RoundDown(std::exp(x.Lower())), static_cast<T>(0)),
+    Interval<T>::RoundUp(std::exp(x.Upper())));
+}
+
+// Points outside the domain are dropped, an interval entirely outside it gives NaN bounds
+template<std::floating_point T>
+Interval<T> log(const Interval<T>& x)
+{
+  constexpr T inf = std::numeric_limits<T>::infinity();
+  const T lo = (x.Lower() <= static_cast<T>(0)) ? -inf : Interval<T>::RoundDown(std::log(x.Lower()));
+  return Interval<T>(lo, Interval<T>::RoundUp(std::log(x.Upper())));
+}
+
+template<std::floating_point T>
+Interval<T> sqrt(const Interval<T>& x)
+{
+  const T lo = (x.Lower() <= static_cast<T>(0)) ? static_cast<T>(0) : Interval<T>::RoundDown(std::sqrt(x.Lower()));
+  return Interval<T>(lo, Interval<T>::RoundUp(std::sqrt(x.Upper())));
+}
+
+template<std::floating_point T>
+Interval<T> pow(const Interval<T>& base, const Interval<T>& exponent)
+{
+  constexpr T zero = static_cast<T>(0);
+  if (exponent.IsPoint() && (std::trunc(exponent.Lower()) == exponent.Lower())) {
+    const T n = exponent.Lower();
+    if (n == zero) {
+      return Interval<T>(static_cast<T>(1));
+    }
+    // Monotonic on each side of zero; even powers fold the negative side over
+    const bool even = (std::fmod(n, static_cast<T>(2)) == zero);
+    Interval<T> b = even ? abs(base) : base;
+    if (n < zero) {
+      return static_cast<T>(1) / pow(b, Interval<T>(-n));
+    }
+    return Interval<T>::Outward(std::pow(b.Lower(), n), std::pow(b.Upper(), n));
+  }
+  if ((base.Lower() <= zero) && (exponent.Lower() <= zero)) {
+    return Interval<T>::Entire();
+  }
+  return exp(exponent * log(base));
+}
+
+// Maxima of sin are at pi/2 + 2k*pi and minima at -pi/2 + 2k*pi; the extremum
+// tests are padded by an ulp-scale margin so rounding can only widen the result
+template<std::floating_point T>
+bool ContainsPhase(const Interval<T>& x, const T phase, const T period)
+{
+  const T margin = std::numeric_limits<T>::epsilon() * (std::abs(x.Lower()) + std::abs(x.Upper()) + period);
+  const T k_lo = std::ceil((x.Lower() - margin - phase) / period);
+  const T k_hi = std::floor((x.Upper() + margin - phase) / period);
+  return k_lo <= k_hi;
+}
+
+template<std::floating_point T>
+Interval<T> sin(const Interval<T>& x)
+{
+  constexpr T pi = std::numbers::pi_v<T>;
+  constexpr T one = static_cast<T>(1);
+  if (!(x.Width() < static_cast<T>(2) * pi)) {
+    return Interval<T>(-one, one);
+  }
+  const T s1 = std::sin(x.Lower());
+  const T s2 = std::sin(x.Upper());
+  const T hi = ContainsPhase(x, pi / 2, 2 * pi) ? one : std::min(Interval<T>::RoundUp(std::max(s1,s2)), one);
+  const T lo = ContainsPhase(x, -pi / 2, 2 * pi) ? -one : std::max(Interval<T>::RoundDown(std::min(s1,s2)), -one);
+  return Interval<T>(lo, hi);
+}
+
+template<std::floating_point T>
+Interval<T> cos(const Interval<T>& x)
+{
+  constexpr T pi = std::numbers::pi_v<T>;
+  constexpr T one = static_cast<T>(1);
+  if (!(x.Width() < static_cast<T>(2) * pi)) {
+    return Interval<T>(-one, one);
+  }
+  const T c1 = std::cos(x.Lower());
+  const T c2 = std::cos(x.Upper());
+  const T hi = ContainsPhase(x, static_cast<T>(0), 2 * pi) ? one : std::min(Interval<T>::RoundUp(std::max(c1,c2)), one);
+  const T lo = ContainsPhase(x, pi, 2 * pi) ? -one : std::max(Interval<T>::RoundDown(std::min(c1,c2)), -one);
+  return Interval<T>(lo, hi);
+}
+
+// Increasing between the poles at pi/2 + k*pi, unbounded if one is enclosed
+template<std::floating_point T>
+Interval<T> tan(const Interval<T>& x)
+{
+  constexpr T pi = std::numbers::pi_v<T>;
+  if (!(x.Width() < pi) || ContainsPhase(x, pi / 2, pi)) {
+    return Interval<T>::Entire();
+  }
+  return Interval<T>::Outward(std::tan(x.Lower()), std::tan(x.Upper()));
+}
+
+template<std::floating_point T>
+Interval<T> asin(const Interval<T>& x)
+{
+  constexpr T one = static_cast<T>(1);
+  return Interval<T>::Outward(std::asin(std::max(x.Lower(), -one)), std::asin(std::min(x.Upper(), one)));
+}
+
+template<std::floating_point T>
+Interval<T> acos(const Interval<T>& x)
+{
+  constexpr T one = static_cast<T>(1);
+  return Interval<T>::Outward(std::acos(std::min(x.Upper(), one)), std::acos(std::max(x.Lower(), -one)));
+}
+
+template<std::floating_point T>
+Interval<T> atan(const Interval<T>& x)
+{
+  return Interval<T>::Outward(std::atan(x.Lower()), std::atan(x.Upper()));
+}
+
+
+// Bounds of expr over [lo,hi]
+template<typename SymType, std::floating_point T>
+Interval<T> EvaluateRange(const SymbolicBase<SymType>& expr, const T lo, const T hi)
+{
+  return expr.derived().Evaluate(Interval<T>(lo, hi));
+}
+
+
+} // Symbolic namespace
+#endif
@@ -1,23 +1,189 @@
 #ifndef SYMBOLIC_INCLUDE_METAPROGRAMMING_HPP
 #define SYMBOLIC_INCLUDE_METAPROGRAMMING_HPP
 
+#include <array>
+#include <cstddef>
 #include <utility>
 #include <tuple>
 
 
-template<int N, typename... Ts> using NthTypeOf =
-        typename std::tuple_element<N, std::tuple<Ts...>>::type;
+// TYPE LISTS
+// Lookups below take a constant number of instantiations per query and no
+// recursion, so wide sums and products stay clear of the template depth limit.
 
-template<typename T, T Val>
-constexpr bool ValueMatch()
+#if defined(__has_builtin)
+#if __has_builtin(__type_pack_element)
+#define SYMBOLIC_HAS_TYPE_PACK_ELEMENT
+#endif
+#endif
+
+template<std::size_t I, typename T>
+struct indexed_type
+{
+  typedef T type;
+};
+
+// Inherits indexed_type<I,Ts> for every element, built once per pack
+template<typename Seq, typename... Ts>
+struct indexed_types;
+
+template<std::size_t... I, typename... Ts>
+struct indexed_types<std::index_sequence<I...>, Ts...> : indexed_type<I,Ts>... {};
+
+// Picks the base for index I by overload resolution, in place of recursing down the pack
+template<std::size_t I, typename T>
+indexed_type<I,T> select_indexed(const indexed_type<I,T>&);
+
+template<std::size_t N, typename... Ts>
+struct nth_type
+{
+  static_assert(N < sizeof...(Ts), "nth_type: index out of range");
+  typedef typename decltype(select_indexed<N>(
+    std::declval<indexed_types<std::index_sequence_for<Ts...>, Ts...>>()))::type type;
+};
+
+#ifdef SYMBOLIC_HAS_TYPE_PACK_ELEMENT
+template<int N, typename... Ts> using NthTypeOf = __type_pack_element<N, Ts...>;
+#else
+template<int N, typename... Ts> using NthTypeOf = typename nth_type<N, Ts...>::type;
+#endif
+
+template<typename... Ts>
+struct type_list
+{
+  static constexpr std::size_t size = sizeof...(Ts);
+};
+
+template<std::size_t N, typename List>
+struct type_list_element;
+
+template<std::size_t N, typename... Ts>
+struct type_list_element<N, type_list<Ts...>>
+{
+  typedef NthTypeOf<N, Ts...> type;
+};
+
+template<std::size_t N, typename List>
+using type_list_element_t = typename type_list_element<N, List>::type;
+
+
+// INDEX LOOKUPS
+// Position of the first true value, or sizeof...(Values) when there is none
+template<bool... Values>
+constexpr std::size_t FirstTrue()
+{
+  constexpr bool values[] = { Values..., false };
+  std::size_t i = 0;
+  while (i < sizeof...(Values) && !values[i]) {
+    ++i;
+  }
+  return i;
+}
+
+// Position of the last true value, or sizeof...(Values) when there is none
+template<bool... Values>
+constexpr std::size_t LastTrue()
+{
+  constexpr bool values[] = { Values..., false };
+  for (std::size_t i = sizeof...(Values); i > 0; --i) {
+    if (values[i-1]) {
+      return i-1;
+    }
+  }
+  return sizeof...(Values);
+}
+
+template<template<typename, typename> class Pred, typename T, typename... Us>
+constexpr std::array<bool, sizeof...(Us)> PairRow(type_list<Us...>)
+{
+  return { Pred<T,Us>::value... };
+}
+
+// Pred<T,U>::value for every pair of elements, one row per element of the first list
+template<template<typename, typename> class Pred, typename... Ts, typename List2>
+constexpr auto PairMatrix(type_list<Ts...>, List2 list2)
 {
-  return false;
+  return std::array<std::array<bool, List2::size>, sizeof...(Ts)> { PairRow<Pred,Ts>(list2)... };
 }
 
-template<typename T, T Val, T Num, T... Nums>
+// The first size values, usable as a template argument
+template<std::size_t Capacity>
+struct index_array
+{
+  std::size_t size = 0;
+  std::array<std::size_t, Capacity> values {};
+};
+
+template<auto Array, std::size_t... K>
+constexpr std::index_sequence<Array.values[K]...> ArrayIndices(std::index_sequence<K...>)
+{ return {}; }
+
+template<auto Array>
+using indices_t = decltype(ArrayIndices<Array>(std::make_index_sequence<Array.size>()));
+
+// Pairs (first[k], second[k]), with first increasing
+template<std::size_t Capacity>
+struct index_pairs
+{
+  std::size_t size = 0;
+  std::array<std::size_t, Capacity> first {};
+  std::array<std::size_t, Capacity> second {};
+};
+
+// Pairs each row with the first column it matches that no earlier row took
+template<std::size_t N, std::size_t M>
+constexpr auto GreedyPairs(const std::array<std::array<bool, M>, N>& matrix)
+{
+  index_pairs<(N < M ? N : M)> pairs;
+  std::array<bool, M> taken {};
+  for (std::size_t n = 0; n < N; ++n) {
+    for (std::size_t m = 0; m < M; ++m) {
+      if (matrix[n][m] && !taken[m]) {
+        taken[m] = true;
+        pairs.first[pairs.size] = n;
+        pairs.second[pairs.size] = m;
+        ++pairs.size;
+        break;
+      }
+    }
+  }
+  return pairs;
+}
+
+// Greedy pairing of the elements of two lists by Pred
+template<template<typename, typename> class Pred, typename List1, typename List2>
+constexpr auto greedy_pairs_v = GreedyPairs(PairMatrix<Pred>(List1(), List2()));
+
+// Position k of the pair (n, second[k]), or Pairs.size when n is unpaired
+template<auto Pairs>
+constexpr std::size_t PairOf(const std::size_t n)
+{
+  std::size_t k = 0;
+  while (k < Pairs.size && Pairs.first[k] != n) {
+    ++k;
+  }
+  return k;
+}
+
+template<auto Pairs, std::size_t... K>
+constexpr std::index_sequence<Pairs.first[K]...> FirstIndices(std::index_sequence<K...>)
+{ return {}; }
+
+template<auto Pairs, std::size_t... K>
+constexpr std::index_sequence<Pairs.second[K]...> SecondIndices(std::index_sequence<K...>)
+{ return {}; }
+
+template<auto Pairs>
+using first_indices_t = decltype(FirstIndices<Pairs>(std::make_index_sequence<Pairs.size>()));
+
+template<auto Pairs>
+using second_indices_t = decltype(SecondIndices<Pairs>(std::make_index_sequence<Pairs.size>()));
+
+
+template<typename T, T Val, T... Nums>
 constexpr bool ValueMatch()
 {
-  return (Val == Num) || ValueMatch<std::size_t, Val, Nums...>();
+  return ((Val == Nums) || ...);
 }
 
 template<std::size_t Val, std::size_t... Nums>
@@ -80,57 +246,43 @@ constexpr auto index_sequence_cat(const std::index_sequence<Seq1...>, const std:
 //   return index_sequence_without(std::make_index_sequence<N>(), remove);
 // }
 
-template<std::size_t I, std::size_t N, std::size_t... Remove, std::size_t... Stored>
-constexpr auto index_sequence_without_helper(const std::index_sequence<Stored...> stored)
+// Positions of the true values
+template<bool... Keep>
+constexpr auto SelectedIndices()
 {
-  static_assert(I < N, "index_sequence_without_helper: !(I < N)");
-  if constexpr (!IndexMatch<I, Remove...>()) {
-    if constexpr (I == (N-1)) {
-      return std::index_sequence<Stored..., I>();
-    } else {
-      return index_sequence_without_helper<I+1, N, Remove...>(std::index_sequence<Stored..., I>());
-    }
-  }
-  else {
-    if constexpr (I == (N-1)) {
-      return std::index_sequence<Stored...>();
-    } else {
-      return index_sequence_without_helper<I+1, N, Remove...>(stored);
+  constexpr bool keep[] = { Keep..., false };
+  index_array<sizeof...(Keep)> selected;
+  for (std::size_t i = 0; i < sizeof...(Keep); ++i) {
+    if (keep[i]) {
+      selected.values[selected.size++] = i;
     }
   }
+  return selected;
 }
 
-// I is index, N is total size
-template<std::size_t I, std::size_t N, std::size_t... Remove>
-constexpr auto index_sequence_without_helper()
+// Indices [0,N) other than Remove..., in increasing order
+template<std::size_t N, std::size_t... Remove>
+constexpr auto KeptIndices()
 {
-  static_assert(I < N, "index_sequence_without_helper: !(I < N)");
-  if constexpr (!IndexMatch<I, Remove...>()) {
-    if constexpr (I == (N-1)) {
-      return std::index_sequence<I>();
-    } else {
-      return index_sequence_without_helper<I+1, N, Remove...>(std::index_sequence<I>());
-    }
-  }
-  else {
-    if constexpr (I == (N-1)) {
-      return;
-    } else {
-      return index_sequence_without_helper<I+1, N, Remove...>();
+  index_array<N> kept;
+  for (std::size_t i = 0; i < N; ++i) {
+    if (!((i == Remove) || ...)) {
+      kept.values[kept.size++] = i;
     }
   }
+  return kept;
 }
 
 template<std::size_t N, std::size_t... Remove>
 constexpr auto index_sequence_without(const std::index_sequence<Remove...>)
 {
-  return index_sequence_without_helper<0,N,Remove...>();
+  return indices_t<KeptIndices<N, Remove...>()>();
 }
 
 template<std::size_t N, std::size_t... Remove>
 constexpr auto index_sequence_without()
 {
-  return index_sequence_without_helper<0,N,Remove...>();
+  return indices_t<KeptIndices<N, Remove...>()>();
 }
 
 
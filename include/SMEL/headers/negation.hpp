@@ -10,12 +10,14 @@ template<typename SymType>
 class Negation : public SymbolicBase< Negation<SymType> >
 {
 private:
-  typename std::conditional_t<SymType::is_leaf, const SymType&, const SymType> expr_;
+  [[no_unique_address]] Branch<SymType> expr_;
 
 public:
   static constexpr bool is_leaf = false;
   static constexpr bool is_dynamic = SymType::is_dynamic;
 
+  constexpr Negation() = default;
+
   constexpr Negation(const SymType& expr)
       : expr_{expr}
   {}
@@ -23,19 +25,23 @@ public:
   template<typename FloatType>
   constexpr FloatType Evaluate(const FloatType input) const
   { 
-    return -(expr_.Evaluate(input));
+    return -(expr_->Evaluate(input));
   }
 
   constexpr auto Derivative() const
-  { return -(expr_.Derivative()); }
+  { return -(expr_->Derivative()); }
 
   std::string str() const
-  { return "-(" + expr_.str() + ')'; }
+  { return "-(" + expr_->str() + ')'; }
+
+  constexpr auto Negate() const
+  {
+    return *expr_;
+  }
 
-  typename std::conditional_t<SymType::is_leaf, const SymType&, const SymType>
-  constexpr Negate() const
+  constexpr auto Argument() const
   {
-    return expr_;
+    return *expr_;
   }
 };
 
@@ -0,0 +1,248 @@
+#ifndef SYMBOLIC_INCLUDE_OPTIMIZE_HPP
+#define SYMBOLIC_INCLUDE_OPTIMIZE_HPP
+
+#include <tuple>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "prototyping.hpp"
+#include "type_deductions.hpp"
+#include "structure.hpp"
+#include "cost.hpp"
+#include "quotient_operator.hpp"
+
+// How many rewrites Cheapest may chain on top of each other below a node
+#ifndef SYMBOLIC_CHEAPEST_DEPTH
+#define SYMBOLIC_CHEAPEST_DEPTH 3
+#endif
+
+
+namespace SYMBOLIC_NAMESPACE_NAME {
+
+template<std::size_t Budget, typename Weights, typename SymType>
+constexpr auto CheapestImpl(const SymbolicBase<SymType>& expr);
+
+
+// Lowest eval_cost of the arguments, the first one on ties
+template<typename Weights, typename SymType>
+constexpr auto CheapestOf(const SymType& expr)
+{
+  return expr;
+}
+
+template<typename Weights, typename Sym1, typename Sym2, typename... Syms>
+constexpr auto CheapestOf(const Sym1& expr1, const Sym2& expr2, const Syms&... exprs)
+{
+  if constexpr (eval_cost_v<Sym2,Weights> < eval_cost_v<Sym1,Weights>) {
+    return CheapestOf<Weights>(expr2, exprs...);
+  } else {
+    return CheapestOf<Weights>(expr1, exprs...);
+  }
+}
+
+
+// FACTORING: sum_i t_i -> b * sum_i (t_i / b) for a base b found in every term
+template<typename BaseType, class... Terms>
+constexpr bool in_every_term_v =
+  ((matching_factor<BaseType, decltype(FactorTuple(std::declval<Terms>()))>::value
+    < std::tuple_size_v<decltype(FactorTuple(std::declval<Terms>()))>) && ...);
+
+template<typename TermType, class... Terms>
+struct common_factor_index
+{
+  typedef decltype(FactorTuple(std::declval<TermType>())) FirstFactors;
+
+  template<std::size_t... I>
+  static constexpr std::size_t find(std::index_sequence<I...>)
+  {
+    return FirstTrue<in_every_term_v<factor_base_t<std::tuple_element_t<I,FirstFactors>>, Terms...>...>();
+  }
+
+  static constexpr std::size_t value = find(std::make_index_sequence<std::tuple_size_v<FirstFactors>>());
+  static constexpr bool found = (value < std::tuple_size_v<FirstFactors>);
+};
+
+template<std::size_t Budget, typename Weights, class... Syms, std::size_t... I>
+constexpr auto Factored(const TupleSum<Syms...>& sum, const std::index_sequence<I...>)
+{
+  typedef common_factor_index<NthTypeOf<0,Syms...>, Syms...> Common;
+  if constexpr (!Common::found) {
+    return sum;
+  } else {
+    const auto common = FactorBase(std::get<Common::value>(FactorTuple(get<0>(sum))));
+    return common * CheapestImpl<Budget-1,Weights>(((get<I>(sum) / common) + ...));
+  }
+}
+
+
+// DISTRIBUTION: rest * (s_1 + ... + s_n) -> rest * s_1 + ... + rest * s_n
+template<std::size_t Budget, typename Weights, typename RestType, class... Terms, std::size_t... J>
+constexpr auto DistributeOver(const RestType& rest, const TupleSum<Terms...>& sum, const std::index_sequence<J...>)
+{
+  return (CheapestImpl<Budget-1,Weights>(rest * get<J>(sum)) + ...);
+}
+
+template<std::size_t Budget, typename Weights, class... Syms>
+constexpr auto Distributed(const TupleProduct<Syms...>& prod)
+{
+  constexpr std::size_t N = FirstTrue<is_sum_v<Syms>...>();
+  if constexpr (N == sizeof...(Syms)) {
+    return prod;
+  } else {
+    typedef NthTypeOf<N,Syms...> SumType;
+    return DistributeOver<Budget,Weights>(
+      prod.template Without<N>(), get<N>(prod), std::make_index_sequence<SumType::size>());
+  }
+}
+
+
+// RECIPROCAL HOISTING: the terms of a sum are brought over one denominator so
+// that it evaluates with a single division
+template<typename NumType, typename DenType, typename TermType>
+constexpr auto AddOverDenominator(const NumType& num, const DenType& den, const TermType& term)
+{
+  if constexpr (is_quotient_v<TermType>) {
+    if constexpr (is_same_v<DenType, std::decay_t<decltype(term.Denominator())>>) {
+      return std::make_pair(num + term.Numerator(), den);
+    } else {
+      return std::make_pair(
+        (num * term.Denominator()) + (term.Numerator() * den),
+        den * term.Denominator());
+    }
+  } else {
+    return std::make_pair(num + (term * den), den);
+  }
+}
+
+template<typename NumType, typename DenType>
+constexpr auto OverDenominator(const NumType& num, const DenType& den)
+{
+  return std::make_pair(num, den);
+}
+
+template<typename NumType, typename DenType, typename TermType, typename... TermTypes>
+constexpr auto OverDenominator(const NumType& num, const DenType& den, const TermType& term, const TermTypes&... terms)
+{
+  const auto [next_num, next_den] = AddOverDenominator(num, den, term);
+  return OverDenominator(next_num, next_den, terms...);
+}
+
+template<std::size_t Budget, typename Weights, class... Syms, std::size_t... I>
+constexpr auto CommonDenominator(const TupleSum<Syms...>& sum, const std::index_sequence<I...>)
+{
+  if constexpr (!(is_quotient_v<Syms> || ...)) {
+    return sum;
+  } else {
+    // Start from a quotient term so the first denominator isn't One
+    constexpr bool quotient_terms[] = { is_quotient_v<Syms>... };
+    constexpr std::size_t first = [&]() {
+      std::size_t index = 0;
+      while (!quotient_terms[index]) {
+        ++index;
+      }
+      return index;
+    }();
+    const auto start = get<first>(sum);
+    const auto [num, den] = [&]<std::size_t... J>(std::index_sequence<J...>) {
+      return OverDenominator(start.Numerator(), start.Denominator(), get<J>(sum)...);
+    }(index_sequence_without<sizeof...(Syms), first>());
+    return CheapestImpl<Budget-1,Weights>(num) / den;
+  }
+}
+
+
+// POWERS: small integer powers are multiplied out, x^3 -> x * x * x and
+// x^-2 -> 1 / (x * x), bypassing the operators that would merge them back
+template<typename SymType>
+struct integer_power
+{
+  static constexpr bool value = false;
+  static constexpr std::int64_t power = 0;
+};
+
+template<std::integral T, T Val>
+struct integer_power<Constant<T,Val>>
+{
+  static constexpr bool value = true;
+  static constexpr std::int64_t power = static_cast<std::int64_t>(Val);
+};
+
+inline constexpr std::int64_t max_expanded_power = 4;
+
+template<std::size_t, typename SymType>
+using repeat_t = SymType;
+
+template<typename Base, std::size_t... I>
+constexpr auto RepeatedProduct(const Base& base, const std::index_sequence<I...>)
+{
+  if constexpr (sizeof...(I) == 1) {
+    return base;
+  } else {
+    return TupleProduct<repeat_t<I,Base>...>(((void)I, base)...);
+  }
+}
+
+template<typename Base_, typename Exponent_>
+constexpr auto ExpandedPower(const Exponential<Base_,Exponent_>& expr)
+{
+  constexpr std::int64_t power = integer_power<Exponent_>::power;
+  if constexpr (!integer_power<Exponent_>::value || power == 0
+      || power > max_expanded_power || power < -max_expanded_power) {
+    return expr;
+  }
+  else if constexpr (power > 0) {
+    return RepeatedProduct(expr.Base(), std::make_index_sequence<power>());
+  }
+  else {
+    return Quotient(One<>(), RepeatedProduct(expr.Base(), std::make_index_sequence<-power>()));
+  }
+}
+
+
+template<std::size_t Budget, typename Weights, typename SymType>
+constexpr auto CheapestImpl(const SymbolicBase<SymType>& expr)
+{
+  const auto children = std::apply(
+    [](const auto&... child) { return std::make_tuple(CheapestImpl<Budget,Weights>(child)...); },
+    Children(expr));
+  const auto rebuilt = std::apply(
+    [&](const auto&... child) { return Rebuild(expr, child...); }, children);
+  const auto merged = std::apply(
+    [&](const auto&... child) { return Reapply(expr, child...); }, children);
+  typedef std::decay_t<decltype(rebuilt)> Node;
+
+  if constexpr (Budget == 0) {
+    return CheapestOf<Weights>(rebuilt, merged);
+  }
+  else if constexpr (is_sum_v<Node>) {
+    return CheapestOf<Weights>(rebuilt, merged,
+      Factored<Budget,Weights>(rebuilt, std::make_index_sequence<Node::size>()),
+      CommonDenominator<Budget,Weights>(rebuilt, std::make_index_sequence<Node::size>()));
+  }
+  else if constexpr (is_product_v<Node>) {
+    return CheapestOf<Weights>(rebuilt, merged, Distributed<Budget,Weights>(rebuilt));
+  }
+  else if constexpr (is_exponential_v<Node>) {
+    return CheapestOf<Weights>(rebuilt, merged, ExpandedPower(rebuilt));
+  }
+  else {
+    return CheapestOf<Weights>(rebuilt, merged);
+  }
+}
+
+// Equivalent form of expr with the lowest eval_cost, chosen at compile time
+// among a bounded set of rewrites applied bottom up: factoring out a base common
+// to every term of a sum, distributing a product over a sum, bringing a sum
+// over a common denominator, multiplying out small integer powers, and
+// re-simplifying through the operators (merging powers and like terms).
+template<typename Weights = CostWeights, typename SymType>
+constexpr auto Cheapest(const SymbolicBase<SymType>& expr)
+{
+  return CheapestImpl<SYMBOLIC_CHEAPEST_DEPTH, Weights>(expr);
+}
+
+
+} // Symbolic namespace
+#endif
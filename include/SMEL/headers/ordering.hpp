@@ -0,0 +1,307 @@
+#ifndef SYMBOLIC_INCLUDE_ORDERING_HPP
+#define SYMBOLIC_INCLUDE_ORDERING_HPP
+
+#include <array>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
+#include "metaprogramming.hpp"
+#include "symbolic_base.hpp"
+#include "prototyping.hpp"
+#include "constants.hpp"
+
+
+namespace SYMBOLIC_NAMESPACE_NAME {
+
+// Sort key of each node class. Numeric constants come first so that sums and
+// products always lead with their constant term or coefficient.
+enum class NodeKind : int
+{
+  Constant,
+  IntegerFraction,
+  RuntimeConstant,
+  Reference,
+  Symbol,
+  Negation,
+  Sum,
+  Product,
+  Quotient,
+  Exponential,
+  Logarithm,
+  Sine,
+  Cosine,
+  Tangent,
+  Secant,
+  Cotangent,
+  Cosecant,
+  ArcSine,
+  ArcCosine,
+  ArcTangent,
+  ArcSecant,
+  ArcCotangent,
+  ArcCosecant,
+  AbsoluteValue,
+  Signum,
+  Unknown
+};
+
+
+// NODE KIND
+template<typename SymType>
+struct node_kind
+{
+  static constexpr NodeKind value = NodeKind::Unknown;
+};
+
+template<typename T, T Val>
+struct node_kind<Constant<T,Val>> { static constexpr NodeKind value = NodeKind::Constant; };
+
+template<typename T1, T1 Val1, typename T2, T2 Val2>
+struct node_kind<Quotient<Constant<T1,Val1>,Constant<T2,Val2>>> { static constexpr NodeKind value = NodeKind::IntegerFraction; };
+
+template<typename T>
+struct node_kind<RuntimeConstant<T>> { static constexpr NodeKind value = NodeKind::RuntimeConstant; };
+
+template<typename T>
+struct node_kind<Reference<T>> { static constexpr NodeKind value = NodeKind::Reference; };
+
+template<>
+struct node_kind<Symbol> { static constexpr NodeKind value = NodeKind::Symbol; };
+
+template<typename SymType>
+struct node_kind<Negation<SymType>> { static constexpr NodeKind value = NodeKind::Negation; };
+
+template<typename... Syms>
+struct node_kind<TupleSum<Syms...>> { static constexpr NodeKind value = NodeKind::Sum; };
+
+template<typename... Syms>
+struct node_kind<TupleProduct<Syms...>> { static constexpr NodeKind value = NodeKind::Product; };
+
+template<typename Sym1, typename Sym2>
+struct node_kind<Quotient<Sym1,Sym2>> { static constexpr NodeKind value = NodeKind::Quotient; };
+
+template<typename Sym1, typename Sym2>
+struct node_kind<Exponential<Sym1,Sym2>> { static constexpr NodeKind value = NodeKind::Exponential; };
+
+template<typename Sym1, typename Sym2>
+struct node_kind<Logarithm<Sym1,Sym2>> { static constexpr NodeKind value = NodeKind::Logarithm; };
+
+template<typename SymType>
+struct node_kind<Sine<SymType>> { static constexpr NodeKind value = NodeKind::Sine; };
+
+template<typename SymType>
+struct node_kind<Cosine<SymType>> { static constexpr NodeKind value = NodeKind::Cosine; };
+
+template<typename SymType>
+struct node_kind<Tangent<SymType>> { static constexpr NodeKind value = NodeKind::Tangent; };
+
+template<typename SymType>
+struct node_kind<Secant<SymType>> { static constexpr NodeKind value = NodeKind::Secant; };
+
+template<typename SymType>
+struct node_kind<Cotangent<SymType>> { static constexpr NodeKind value = NodeKind::Cotangent; };
+
+template<typename SymType>
+struct node_kind<Cosecant<SymType>> { static constexpr NodeKind value = NodeKind::Cosecant; };
+
+template<typename SymType>
+struct node_kind<ArcSine<SymType>> { static constexpr NodeKind value = NodeKind::ArcSine; };
+
+template<typename SymType>
+struct node_kind<ArcCosine<SymType>> { static constexpr NodeKind value = NodeKind::ArcCosine; };
+
+template<typename SymType>
+struct node_kind<ArcTangent<SymType>> { static constexpr NodeKind value = NodeKind::ArcTangent; };
+
+template<typename SymType>
+struct node_kind<ArcSecant<SymType>> { static constexpr NodeKind value = NodeKind::ArcSecant; };
+
+template<typename SymType>
+struct node_kind<ArcCotangent<SymType>> { static constexpr NodeKind value = NodeKind::ArcCotangent; };
+
+template<typename SymType>
+struct node_kind<ArcCosecant<SymType>> { static constexpr NodeKind value = NodeKind::ArcCosecant; };
+
+template<typename SymType>
+struct node_kind<AbsoluteValue<SymType>> { static constexpr NodeKind value = NodeKind::AbsoluteValue; };
+
+template<typename SymType>
+struct node_kind<Signum<SymType>> { static constexpr NodeKind value = NodeKind::Signum; };
+
+template<typename SymType>
+constexpr NodeKind node_kind_v = node_kind<SymType>::value;
+
+
+// NODE CHILDREN
+// Every template argument of a composite node is one of its child expressions
+template<typename SymType>
+struct node_children
+{
+  typedef type_list<> type;
+};
+
+template<template<typename...> class Node, typename... Syms>
+struct node_children<Node<Syms...>>
+{
+  typedef type_list<Syms...> type;
+};
+
+template<typename T>
+struct node_children<RuntimeConstant<T>>
+{
+  typedef type_list<> type;
+};
+
+template<typename T>
+struct node_children<Reference<T>>
+{
+  typedef type_list<> type;
+};
+
+template<typename SymType>
+using node_children_t = typename node_children<SymType>::type;
+
+
+// NUMERIC VALUE of compile-time constants, used to order them. The type rank
+// breaks ties between equal values stored in different types, e.g. 2 and 2.0
+template<typename SymType>
+struct constant_value
+{
+  static constexpr long double value = 0;
+  static constexpr std::size_t type_rank = 0;
+};
+
+template<typename T, T Val>
+struct constant_value<Constant<T,Val>>
+{
+  static constexpr long double value = static_cast<long double>(Val);
+  static constexpr std::size_t type_rank = (std::is_floating_point_v<T> ? 64 : 0) + sizeof(T);
+};
+
+template<typename T1, T1 Val1, typename T2, T2 Val2>
+struct constant_value<Quotient<Constant<T1,Val1>,Constant<T2,Val2>>>
+{
+  static constexpr long double value = static_cast<long double>(Val1) / static_cast<long double>(Val2);
+  static constexpr std::size_t type_rank = sizeof(T1) + sizeof(T2);
+};
+
+
+// TYPE COMPARE
+// Order on expression types: negative, zero or positive like strcmp. Distinct
+// static types only compare equal in corner cases (e.g. two integer constants of
+// the same value and width); dynamic leaves of one kind always compare equal so
+// the stable sort keeps their construction order.
+template<typename Sym1, typename Sym2>
+struct type_compare;
+
+template<typename Sym1, typename Sym2>
+constexpr int type_compare_v = type_compare<Sym1,Sym2>::value;
+
+template<typename... Sym1, typename... Sym2>
+constexpr int ChildrenCompare(type_list<Sym1...>, type_list<Sym2...>)
+{
+  if constexpr (sizeof...(Sym1) != sizeof...(Sym2)) {
+    return (sizeof...(Sym1) < sizeof...(Sym2)) ? -1 : 1;
+  }
+  else {
+    int result = 0;
+    ((result = (result != 0) ? result : type_compare_v<Sym1,Sym2>), ...);
+    return result;
+  }
+}
+
+template<typename Sym1, typename Sym2>
+struct type_compare
+{
+  static constexpr int compare()
+  {
+    constexpr NodeKind kind1 = node_kind_v<Sym1>;
+    constexpr NodeKind kind2 = node_kind_v<Sym2>;
+    if constexpr (std::is_same_v<Sym1,Sym2>) {
+      return 0;
+    }
+    else if constexpr (kind1 != kind2) {
+      return (kind1 < kind2) ? -1 : 1;
+    }
+    else if constexpr (kind1 == NodeKind::Constant || kind1 == NodeKind::IntegerFraction) {
+      constexpr long double val1 = constant_value<Sym1>::value;
+      constexpr long double val2 = constant_value<Sym2>::value;
+      constexpr std::size_t rank1 = constant_value<Sym1>::type_rank;
+      constexpr std::size_t rank2 = constant_value<Sym2>::type_rank;
+      if constexpr (val1 != val2) {
+        return (val1 < val2) ? -1 : 1;
+      } else {
+        return (rank1 == rank2) ? 0 : ((rank1 < rank2) ? -1 : 1);
+      }
+    }
+    else {
+      return ChildrenCompare(node_children_t<Sym1>(), node_children_t<Sym2>());
+    }
+  }
+
+  static constexpr int value = compare();
+};
+
+
+// CANONICAL ORDER
+// index_sequence listing the positions of Syms... in sorted order
+template<typename... Syms>
+struct canonical_order
+{
+  static constexpr std::size_t N = sizeof...(Syms);
+
+  template<std::size_t... I>
+  static constexpr auto compare_matrix(std::index_sequence<I...>)
+  {
+    return std::array<int, N*N> { type_compare_v<NthTypeOf<I / N, Syms...>, NthTypeOf<I % N, Syms...>>... };
+  }
+
+  // Stable: ties keep their relative order
+  static constexpr std::array<std::size_t, N> sorted_positions()
+  {
+    constexpr auto cmp = compare_matrix(std::make_index_sequence<N*N>());
+    std::array<std::size_t, N> order {};
+    for (std::size_t i = 0; i < N; ++i) {
+      std::size_t rank = 0;
+      for (std::size_t j = 0; j < N; ++j) {
+        if ((cmp[j*N + i] < 0) || ((cmp[j*N + i] == 0) && (j < i))) {
+          ++rank;
+        }
+      }
+      order[rank] = i;
+    }
+    return order;
+  }
+
+  static constexpr std::array<std::size_t, N> positions = sorted_positions();
+
+  template<std::size_t... I>
+  static constexpr auto as_sequence(std::index_sequence<I...>)
+  {
+    return std::index_sequence<positions[I]...>();
+  }
+
+  typedef decltype(as_sequence(std::make_index_sequence<N>())) type;
+};
+
+template<typename... Syms>
+using canonical_order_t = typename canonical_order<Syms...>::type;
+
+
+template<template<typename...> class Node, class TupleType, std::size_t... I>
+constexpr auto MakeCanonicalImpl(const TupleType& exprs, const std::index_sequence<I...>)
+{
+  return Node< std::decay_t<std::tuple_element_t<I, TupleType>>... >(std::get<I>(exprs)...);
+}
+
+// Builds Node<...> with its children in canonical order
+template<template<typename...> class Node, class... ExprTypes>
+constexpr auto MakeCanonical(const ExprTypes&... exprs)
+{
+  return MakeCanonicalImpl<Node>(std::forward_as_tuple(exprs...), canonical_order_t<ExprTypes...>());
+}
+
+
+} // Symbolic namespace
+#endif
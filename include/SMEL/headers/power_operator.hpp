@@ -25,7 +25,7 @@ operator^(const SymbolicBase<Sym1>& expr1, const SymbolicBase<Sym2>& expr2)
     return One<>();
   }
   else {
-    return Exponential(expr1.derived(),expr2.derived());
+    return ApplyConstructionRules(Exponential(expr1.derived(),expr2.derived()));
   }
 }
 
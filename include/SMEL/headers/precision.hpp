@@ -0,0 +1,615 @@
+#ifndef SYMBOLIC_INCLUDE_PRECISION_HPP
+#define SYMBOLIC_INCLUDE_PRECISION_HPP
+
+#include <bit>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <compare>
+#include <numbers>
+#include <ostream>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <concepts>
+#include <algorithm>
+#include <type_traits>
+
+#if __has_include(<stdfloat>)
+#include <stdfloat>
+#endif
+
+#include "symbolic_base.hpp"
+
+
+namespace SYMBOLIC_NAMESPACE_NAME {
+
+/*
+  Precision policies for the elementary functions of Approximate numbers.
+
+  Precise calls the standard library. Fast and Faster reduce the argument and
+  evaluate a minimax polynomial of lower degree, with these maximum relative
+  errors (measured in double; float rounding raises Fast to about 4e-7):
+
+              exp      log      sin/cos   tan      atan/asin/acos
+    Fast      8e-8     1.2e-7   4e-8      3e-8     2e-8
+    Faster    8e-5     2.3e-5   1.2e-5    1.1e-5   1.9e-5
+
+  pow(x,y) is exact repeated multiplication for integer |y| <= 64, and
+  exp(y log x) otherwise, whose error grows with |y log x|.
+
+  Edge handling is mostly skipped: log and non-integer pow take positive
+  normal numbers, and sin, cos and tan lose accuracy beyond |x| = 1e6 and
+  return meaningless, possibly infinite values far beyond it. exp saturates instead of
+  underflowing or overflowing, to numbers near 2^-1022 and 2^1023. NaN gives
+  NaN in exp, sin, cos and tan, and infinities give NaN in sin, cos and tan.
+  sqrt, abs and the arithmetic are exact in every tier.
+*/
+struct Precise
+{};
+
+struct Fast
+{
+  // 2^f over f in [-1/2,1/2]
+  static constexpr std::array<double,6> exp2_poly = {
+    1.0000000716546416, 0.69314696706526502, 0.24022119723969168,
+    0.055507132728753586, 0.0096755413310232758, 0.0013276472167828817 };
+  // log(m)/s over s^2, s = (m-1)/(m+1) for m in [sqrt(1/2),sqrt(2))
+  static constexpr std::array<double,3> log_poly = {
+    2.000000237374004, 0.66652223700300217, 0.4129637286432134 };
+  // sin(r)/r and cos(r) over r^2 for |r| <= pi/4
+  static constexpr std::array<double,4> sin_poly = {
+    0.99999999676179885, -0.16666650224240995, 0.0083320164531281906, -0.00019501822020485067 };
+  static constexpr std::array<double,4> cos_poly = {
+    0.99999996738629626, -0.49999842434233011, 0.041654419562640044, -0.0013579404088796547 };
+  // atan(t)/t over t^2 for |t| <= tan(pi/8)
+  static constexpr std::array<double,5> atan_poly = {
+    0.99999998199452256, -0.3333279919486874, 0.1997447036614195,
+    -0.13852088324074957, 0.079867368230644734 };
+};
+
+struct Faster
+{
+  static constexpr std::array<double,4> exp2_poly = {
+    0.99992807353515967, 0.69326098545424564, 0.2426111222237535, 0.055171669092611973 };
+  static constexpr std::array<double,2> log_poly = {
+    1.9999554893545601, 0.67867985758674587 };
+  static constexpr std::array<double,3> sin_poly = {
+    0.99999849288733511, -0.16662382309002285, 0.0081500565559487256 };
+  static constexpr std::array<double,3> cos_poly = {
+    0.99998821692230833, -0.49968548472864577, 0.040362293936049572 };
+  static constexpr std::array<double,3> atan_poly = {
+    0.99998197793491084, -0.33139067906325326, 0.16822931509268133 };
+};
+
+
+// ------------------- Kernels -------------------
+template<std::floating_point T, std::size_t N>
+constexpr T Horner(const T z, const std::array<double,N>& c)
+{
+  T p = static_cast<T>(c[N-1]);
+  for (std::size_t i = N-1; i-- > 0;) {
+    p = p * z + static_cast<T>(c[i]);
+  }
+  return p;
+}
+
+// x rounded to the nearest integer, for |x| < 2^(digits-2)
+template<std::floating_point T>
+constexpr T RoundNearest(const T x)
+{
+  constexpr T shifter = static_cast<T>(1.5) * static_cast<T>(std::uint64_t(1) << (std::numeric_limits<T>::digits - 1));
+  return (x + shifter) - shifter;
+}
+
+template<std::floating_point T>
+using float_bits_t = std::conditional_t<sizeof(T) == 8, std::uint64_t, std::uint32_t>;
+
+template<std::floating_point T>
+constexpr bool has_approximations_v = std::numeric_limits<T>::is_iec559 && (sizeof(T) == 4 || sizeof(T) == 8);
+
+// x = k pi/2 + r with |r| <= pi/4, returning r and k mod 4. The first part of
+// pi/2 has 33 bits, so k times it is exact for |k| < 2^20. NaN, infinite and
+// huge k are not converted: r is then NaN or meaningless anyway.
+inline std::pair<double,unsigned> ReduceHalfPi(const double x)
+{
+  constexpr double pio2_1 = 1.57079632673412561417e+00;
+  constexpr double pio2_1t = 6.07710050650619224932e-11;
+  const double k = RoundNearest(x * (2 * std::numbers::inv_pi));
+  const std::int64_t quadrant = (std::abs(k) < 0x1p52) ? static_cast<std::int64_t>(k) : 0;
+  return { (x - k * pio2_1) - k * pio2_1t, static_cast<unsigned>(quadrant) & 3u };
+}
+
+template<typename Policy, std::floating_point T>
+T ApproximateExp(const T x)
+{
+  if constexpr (std::is_same_v<Policy, Precise> || !has_approximations_v<T>) {
+    return std::exp(x);
+  } else {
+    constexpr int mantissa = std::numeric_limits<T>::digits - 1;
+    constexpr int bias = std::numeric_limits<T>::max_exponent - 1;
+    const T t = std::min(std::max(x * std::numbers::log2e_v<T>, static_cast<T>(1 - bias)), static_cast<T>(bias));
+    // NaN passes the clamp: n = 0 keeps the cast defined and t - n NaN
+    const T n = (t == t) ? RoundNearest(t) : static_cast<T>(0);
+    T f = t - n;
+    if constexpr (sizeof(T) == 4) {
+      // t - n loses up to 2^-24 |t|, 8e-6 at the ends of the float range.
+      // x - n log(2) in two parts instead, the first exact times n.
+      constexpr T ln2_hi = 0x1.62ep-1f;
+      constexpr T ln2_lo = static_cast<T>(std::numbers::ln2_v<long double> - 0x1.62ep-1L);
+      const T clamped = std::min(std::max(x, static_cast<T>(1 - bias) * std::numbers::ln2_v<T>), static_cast<T>(bias) * std::numbers::ln2_v<T>);
+      f = ((clamped - n * ln2_hi) - n * ln2_lo) * std::numbers::log2e_v<T>;
+    }
+    const auto scale = static_cast<float_bits_t<T>>(static_cast<std::int64_t>(n) + bias) << mantissa;
+    return Horner(f, Policy::exp2_poly) * std::bit_cast<T>(scale);
+  }
+}
+
+template<typename Policy, std::floating_point T>
+T ApproximateLog(const T x)
+{
+  if constexpr (std::is_same_v<Policy, Precise> || !has_approximations_v<T>) {
+    return std::log(x);
+  } else {
+    typedef float_bits_t<T> Bits;
+    constexpr int mantissa = std::numeric_limits<T>::digits - 1;
+    constexpr int bias = std::numeric_limits<T>::max_exponent - 1;
+    const Bits bits = std::bit_cast<Bits>(x);
+    // x = m 2^e with m in [1,2), moved to [sqrt(1/2),sqrt(2))
+    const T m = std::bit_cast<T>((bits & ((Bits(1) << mantissa) - 1)) | (static_cast<Bits>(bias) << mantissa));
+    const bool high = m > std::numbers::sqrt2_v<T>;
+    const T e = static_cast<T>(static_cast<std::int64_t>(bits >> mantissa) - bias + high);
+    const T r = high ? m * static_cast<T>(0.5) : m;
+    const T s = (r - 1) / (r + 1);
+    return e * std::numbers::ln2_v<T> + s * Horner(s * s, Policy::log_poly);
+  }
+}
+
+template<typename Policy, std::floating_point T>
+T ApproximateSin(const T x)
+{
+  if constexpr (std::is_same_v<Policy, Precise> || !has_approximations_v<T>) {
+    return std::sin(x);
+  } else {
+    const auto [reduced, quadrant] = ReduceHalfPi(static_cast<double>(x));
+    const T r = static_cast<T>(reduced);
+    const T v = (quadrant & 1) ? Horner(r * r, Policy::cos_poly) : r * Horner(r * r, Policy::sin_poly);
+    return (quadrant & 2) ? -v : v;
+  }
+}
+
+template<typename Policy, std::floating_point T>
+T ApproximateCos(const T x)
+{
+  if constexpr (std::is_same_v<Policy, Precise> || !has_approximations_v<T>) {
+    return std::cos(x);
+  } else {
+    const auto [reduced, quadrant] = ReduceHalfPi(static_cast<double>(x));
+    const T r = static_cast<T>(reduced);
+    const T v = (quadrant & 1) ? r * Horner(r * r, Policy::sin_poly) : Horner(r * r, Policy::cos_poly);
+    return ((quadrant + 1) & 2) ? -v : v;
+  }
+}
+
+template<typename Policy, std::floating_point T>
+T ApproximateTan(const T x)
+{
+  if constexpr (std::is_same_v<Policy, Precise> || !has_approximations_v<T>) {
+    return std::tan(x);
+  } else {
+    const auto [reduced, quadrant] = ReduceHalfPi(static_cast<double>(x));
+    const T r = static_cast<T>(reduced);
+    const T s = r * Horner(r * r, Policy::sin_poly);
+    const T c = Horner(r * r, Policy::cos_poly);
+    return (quadrant & 1) ? -c / s : s / c;
+  }
+}
+
+template<typename Policy, std::floating_point T>
+T ApproximateAtan(const T x)
+{
+  if constexpr (std::is_same_v<Policy, Precise> || !has_approximations_v<T>) {
+    return std::atan(x);
+  } else {
+    // atan(a) = pi/2 - atan(1/a) and atan(t) = pi/4 + atan((t-1)/(t+1))
+    constexpr T quarter_pi = std::numbers::pi_v<T> / 4;
+    const T a = std::abs(x);
+    const bool invert = a > 1;
+    const T t = invert ? 1 / a : a;
+    const bool shift = t > static_cast<T>(0.41421356237309503);
+    const T u = shift ? (t - 1) / (t + 1) : t;
+    const T v = u * Horner(u * u, Policy::atan_poly) + (shift ? quarter_pi : static_cast<T>(0));
+    return std::copysign(invert ? 2 * quarter_pi - v : v, x);
+  }
+}
+
+template<typename Policy, std::floating_point T>
+T ApproximateAsin(const T x)
+{
+  if constexpr (std::is_same_v<Policy, Precise> || !has_approximations_v<T>) {
+    return std::asin(x);
+  } else {
+    return ApproximateAtan<Policy>(x / std::sqrt((1 - x) * (1 + x)));
+  }
+}
+
+template<typename Policy, std::floating_point T>
+T ApproximateAcos(const T x)
+{
+  if constexpr (std::is_same_v<Policy, Precise> || !has_approximations_v<T>) {
+    return std::acos(x);
+  } else {
+    return 2 * ApproximateAtan<Policy>(std::sqrt((1 - x) / (1 + x)));
+  }
+}
+
+template<typename Policy, std::floating_point T>
+T ApproximatePow(const T x, const T y)
+{
+  if constexpr (std::is_same_v<Policy, Precise> || !has_approximations_v<T>) {
+    return std::pow(x, y);
+  } else {
+    if (std::abs(y) <= 64 && RoundNearest(y) == y) {
+      unsigned n = static_cast<unsigned>(std::abs(y));
+      T result = 1;
+      T square = x;
+      while (n) {
+        result = (n & 1) ? result * square : result;
+        square *= square;
+        n >>= 1;
+      }
+      return (y < 0) ? 1 / result : result;
+    }
+    return ApproximateExp<Policy>(y * ApproximateLog<Policy>(x));
+  }
+}
+
+
+/*
+  Number evaluating the elementary functions with Policy, usable as the
+  FloatType of any Evaluate call: expressions need no change to run at a
+  lower precision tier.
+*/
+template<typename Policy, std::floating_point T = double>
+class Approximate
+{
+private:
+  T value_;
+
+public:
+  constexpr Approximate() : value_{0}
+  {}
+
+  template<typename U> requires std::is_arithmetic_v<U>
+  explicit constexpr Approximate(const U value) : value_{static_cast<T>(value)}
+  {}
+
+  constexpr T Value() const
+  { return value_; }
+
+  template<std::floating_point U>
+  explicit constexpr operator U() const
+  { return static_cast<U>(value_); }
+
+  constexpr Approximate operator-() const
+  { return Approximate(-value_); }
+
+  constexpr Approximate& operator+=(const Approximate& other)
+  { value_ += other.value_; return *this; }
+
+  constexpr Approximate& operator-=(const Approximate& other)
+  { value_ -= other.value_; return *this; }
+
+  constexpr Approximate& operator*=(const Approximate& other)
+  { value_ *= other.value_; return *this; }
+
+  constexpr Approximate& operator/=(const Approximate& other)
+  { value_ /= other.value_; return *this; }
+
+  friend constexpr Approximate operator+(const Approximate& a, const Approximate& b)
+  { return Approximate(a.value_ + b.value_); }
+
+  friend constexpr Approximate operator-(const Approximate& a, const Approximate& b)
+  { return Approximate(a.value_ - b.value_); }
+
+  friend constexpr Approximate operator*(const Approximate& a, const Approximate& b)
+  { return Approximate(a.value_ * b.value_); }
+
+  friend constexpr Approximate operator/(const Approximate& a, const Approximate& b)
+  { return Approximate(a.value_ / b.value_); }
+
+  friend constexpr bool operator==(const Approximate& a, const Approximate& b)
+  { return a.value_ == b.value_; }
+
+  friend constexpr std::partial_ordering operator<=>(const Approximate& a, const Approximate& b)
+  { return a.value_ <=> b.value_; }
+
+  friend std::ostream& operator<<(std::ostream& os, const Approximate& x)
+  { return os << x.value_; }
+};
+
+
+// Mixed scalar/approximate arithmetic
+template<typename Policy, std::floating_point T, typename U> requires std::is_arithmetic_v<U>
+constexpr Approximate<Policy,T> operator+(const Approximate<Policy,T>& a, const U b)
+{ return a + Approximate<Policy,T>(b); }
+
+template<typename Policy, std::floating_point T, typename U> requires std::is_arithmetic_v<U>
+constexpr Approximate<Policy,T> operator+(const U a, const Approximate<Policy,T>& b)
+{ return Approximate<Policy,T>(a) + b; }
+
+template<typename Policy, std::floating_point T, typename U> requires std::is_arithmetic_v<U>
+constexpr Approximate<Policy,T> operator-(const Approximate<Policy,T>& a, const U b)
+{ return a - Approximate<Policy,T>(b); }
+
+template<typename Policy, std::floating_point T, typename U> requires std::is_arithmetic_v<U>
+constexpr Approximate<Policy,T> operator-(const U a, const Approximate<Policy,T>& b)
+{ return Approximate<Policy,T>(a) - b; }
+
+template<typename Policy, std::floating_point T, typename U> requires std::is_arithmetic_v<U>
+constexpr Approximate<Policy,T> operator*(const Approximate<Policy,T>& a, const U b)
+{ return a * Approximate<Policy,T>(b); }
+
+template<typename Policy, std::floating_point T, typename U> requires std::is_arithmetic_v<U>
+constexpr Approximate<Policy,T> operator*(const U a, const Approximate<Policy,T>& b)
+{ return Approximate<Policy,T>(a) * b; }
+
+template<typename Policy, std::floating_point T, typename U> requires std::is_arithmetic_v<U>
+constexpr Approximate<Policy,T> operator/(const Approximate<Policy,T>& a, const U b)
+{ return a / Approximate<Policy,T>(b); }
+
+template<typename Policy, std::floating_point T, typename U> requires std::is_arithmetic_v<U>
+constexpr Approximate<Policy,T> operator/(const U a, const Approximate<Policy,T>& b)
+{ return Approximate<Policy,T>(a) / b; }
+
+template<typename Policy, std::floating_point T, typename U> requires std::is_arithmetic_v<U>
+constexpr bool operator==(const Approximate<Policy,T>& a, const U b)
+{ return a.Value() == static_cast<T>(b); }
+
+template<typename Policy, std::floating_point T, typename U> requires std::is_arithmetic_v<U>
+constexpr std::partial_ordering operator<=>(const Approximate<Policy,T>& a, const U b)
+{ return a.Value() <=> static_cast<T>(b); }
+
+
+// ------------------- Elementary functions -------------------
+template<typename Policy, std::floating_point T>
+Approximate<Policy,T> exp(const Approximate<Policy,T>& x)
+{ return Approximate<Policy,T>(ApproximateExp<Policy>(x.Value())); }
+
+template<typename Policy, std::floating_point T>
+Approximate<Policy,T> log(const Approximate<Policy,T>& x)
+{ return Approximate<Policy,T>(ApproximateLog<Policy>(x.Value())); }
+
+template<typename Policy, std::floating_point T>
+Approximate<Policy,T> pow(const Approximate<Policy,T>& x, const Approximate<Policy,T>& y)
+{ return Approximate<Policy,T>(ApproximatePow<Policy>(x.Value(), y.Value())); }
+
+template<typename Policy, std::floating_point T>
+Approximate<Policy,T> sqrt(const Approximate<Policy,T>& x)
+{ return Approximate<Policy,T>(std::sqrt(x.Value())); }
+
+template<typename Policy, std::floating_point T>
+Approximate<Policy,T> abs(const Approximate<Policy,T>& x)
+{ return Approximate<Policy,T>(std::abs(x.Value())); }
+
+template<typename Policy, std::floating_point T>
+Approximate<Policy,T> sin(const Approximate<Policy,T>& x)
+{ return Approximate<Policy,T>(ApproximateSin<Policy>(x.Value())); }
+
+template<typename Policy, std::floating_point T>
+Approximate<Policy,T> cos(const Approximate<Policy,T>& x)
+{ return Approximate<Policy,T>(ApproximateCos<Policy>(x.Value())); }
+
+template<typename Policy, std::floating_point T>
+Approximate<Policy,T> tan(const Approximate<Policy,T>& x)
+{ return Approximate<Policy,T>(ApproximateTan<Policy>(x.Value())); }
+
+template<typename Policy, std::floating_point T>
+Approximate<Policy,T> asin(const Approximate<Policy,T>& x)
+{ return Approximate<Policy,T>(ApproximateAsin<Policy>(x.Value())); }
+
+template<typename Policy, std::floating_point T>
+Approximate<Policy,T> acos(const Approximate<Policy,T>& x)
+{ return Approximate<Policy,T>(ApproximateAcos<Policy>(x.Value())); }
+
+template<typename Policy, std::floating_point T>
+Approximate<Policy,T> atan(const Approximate<Policy,T>& x)
+{ return Approximate<Policy,T>(ApproximateAtan<Policy>(x.Value())); }
+
+
+// Value of expr at input with the elementary functions of Policy
+template<typename Policy, typename SymType, std::floating_point T>
+T EvaluateWith(const SymbolicBase<SymType>& expr, const T input)
+{
+  if constexpr (std::is_same_v<Policy, Precise>) {
+    return expr.derived().Evaluate(input);
+  } else {
+    return expr.derived().Evaluate(Approximate<Policy,T>(input)).Value();
+  }
+}
+
+
+
+/*
+  Number keeping its value and all arithmetic in High while the elementary
+  functions run in Low: the leaves and transcendental nodes take the cheaper
+  path, and sums, products and quotients still accumulate without the
+  cancellation of Low. Integer powers up to 64 are products, computed in High.
+  Low may be float, an extended type such as std::float16_t where the compiler
+  supports it, or an Approximate number for a faster tier in Low.
+*/
+template<typename Low = float, std::floating_point High = double>
+class Mixed
+{
+private:
+  High value_;
+
+public:
+  constexpr Mixed() : value_{0}
+  {}
+
+  template<typename U> requires std::is_arithmetic_v<U>
+  explicit constexpr Mixed(const U value) : value_{static_cast<High>(value)}
+  {}
+
+  constexpr High Value() const
+  { return value_; }
+
+  explicit constexpr operator High() const
+  { return value_; }
+
+  // The function f evaluated in Low at this value
+  template<typename Function>
+  constexpr Mixed InLow(const Function& f) const
+  { return Mixed(static_cast<High>(f(static_cast<Low>(value_)))); }
+
+  constexpr Mixed operator-() const
+  { return Mixed(-value_); }
+
+  constexpr Mixed& operator+=(const Mixed& other)
+  { value_ += other.value_; return *this; }
+
+  constexpr Mixed& operator-=(const Mixed& other)
+  { value_ -= other.value_; return *this; }
+
+  constexpr Mixed& operator*=(const Mixed& other)
+  { value_ *= other.value_; return *this; }
+
+  constexpr Mixed& operator/=(const Mixed& other)
+  { value_ /= other.value_; return *this; }
+
+  friend constexpr Mixed operator+(const Mixed& a, const Mixed& b)
+  { return Mixed(a.value_ + b.value_); }
+
+  friend constexpr Mixed operator-(const Mixed& a, const Mixed& b)
+  { return Mixed(a.value_ - b.value_); }
+
+  friend constexpr Mixed operator*(const Mixed& a, const Mixed& b)
+  { return Mixed(a.value_ * b.value_); }
+
+  friend constexpr Mixed operator/(const Mixed& a, const Mixed& b)
+  { return Mixed(a.value_ / b.value_); }
+
+  friend constexpr bool operator==(const Mixed& a, const Mixed& b)
+  { return a.value_ == b.value_; }
+
+  friend constexpr std::partial_ordering operator<=>(const Mixed& a, const Mixed& b)
+  { return a.value_ <=> b.value_; }
+
+  friend std::ostream& operator<<(std::ostream& os, const Mixed& x)
+  { return os << x.value_; }
+};
+
+#if defined(__STDCPP_FLOAT16_T__)
+typedef Mixed<std::float16_t, double> MixedHalf;
+#endif
+#if defined(__STDCPP_BFLOAT16_T__)
+typedef Mixed<std::bfloat16_t, double> MixedBHalf;
+#endif
+
+
+// Mixed scalar/mixed arithmetic
+template<typename Low, std::floating_point High, typename U> requires std::is_arithmetic_v<U>
+constexpr Mixed<Low,High> operator+(const Mixed<Low,High>& a, const U b)
+{ return a + Mixed<Low,High>(b); }
+
+template<typename Low, std::floating_point High, typename U> requires std::is_arithmetic_v<U>
+constexpr Mixed<Low,High> operator+(const U a, const Mixed<Low,High>& b)
+{ return Mixed<Low,High>(a) + b; }
+
+template<typename Low, std::floating_point High, typename U> requires std::is_arithmetic_v<U>
+constexpr Mixed<Low,High> operator-(const Mixed<Low,High>& a, const U b)
+{ return a - Mixed<Low,High>(b); }
+
+template<typename Low, std::floating_point High, typename U> requires std::is_arithmetic_v<U>
+constexpr Mixed<Low,High> operator-(const U a, const Mixed<Low,High>& b)
+{ return Mixed<Low,High>(a) - b; }
+
+template<typename Low, std::floating_point High, typename U> requires std::is_arithmetic_v<U>
+constexpr Mixed<Low,High> operator*(const Mixed<Low,High>& a, const U b)
+{ return a * Mixed<Low,High>(b); }
+
+template<typename Low, std::floating_point High, typename U> requires std::is_arithmetic_v<U>
+constexpr Mixed<Low,High> operator*(const U a, const Mixed<Low,High>& b)
+{ return Mixed<Low,High>(a) * b; }
+
+template<typename Low, std::floating_point High, typename U> requires std::is_arithmetic_v<U>
+constexpr Mixed<Low,High> operator/(const Mixed<Low,High>& a, const U b)
+{ return a / Mixed<Low,High>(b); }
+
+template<typename Low, std::floating_point High, typename U> requires std::is_arithmetic_v<U>
+constexpr Mixed<Low,High> operator/(const U a, const Mixed<Low,High>& b)
+{ return Mixed<Low,High>(a) / b; }
+
+template<typename Low, std::floating_point High, typename U> requires std::is_arithmetic_v<U>
+constexpr bool operator==(const Mixed<Low,High>& a, const U b)
+{ return a.Value() == static_cast<High>(b); }
+
+template<typename Low, std::floating_point High, typename U> requires std::is_arithmetic_v<U>
+constexpr std::partial_ordering operator<=>(const Mixed<Low,High>& a, const U b)
+{ return a.Value() <=> static_cast<High>(b); }
+
+
+// ------------------- Elementary functions in Low -------------------
+template<typename Low, std::floating_point High>
+Mixed<Low,High> exp(const Mixed<Low,High>& x)
+{ return x.InLow([](const Low v) { using std::exp; return exp(v); }); }
+
+template<typename Low, std::floating_point High>
+Mixed<Low,High> log(const Mixed<Low,High>& x)
+{ return x.InLow([](const Low v) { using std::log; return log(v); }); }
+
+template<typename Low, std::floating_point High>
+Mixed<Low,High> pow(const Mixed<Low,High>& x, const Mixed<Low,High>& y)
+{
+  const High n = y.Value();
+  if (std::abs(n) <= 64 && RoundNearest(n) == n) {
+    return Mixed<Low,High>(ApproximatePow<Fast>(x.Value(), n));
+  }
+  using std::pow;
+  return Mixed<Low,High>(static_cast<High>(pow(static_cast<Low>(x.Value()), static_cast<Low>(n))));
+}
+
+template<typename Low, std::floating_point High>
+Mixed<Low,High> sqrt(const Mixed<Low,High>& x)
+{ return x.InLow([](const Low v) { using std::sqrt; return sqrt(v); }); }
+
+template<typename Low, std::floating_point High>
+Mixed<Low,High> abs(const Mixed<Low,High>& x)
+{ return Mixed<Low,High>(std::abs(x.Value())); }
+
+template<typename Low, std::floating_point High>
+Mixed<Low,High> sin(const Mixed<Low,High>& x)
+{ return x.InLow([](const Low v) { using std::sin; return sin(v); }); }
+
+template<typename Low, std::floating_point High>
+Mixed<Low,High> cos(const Mixed<Low,High>& x)
+{ return x.InLow([](const Low v) { using std::cos; return cos(v); }); }
+
+template<typename Low, std::floating_point High>
+Mixed<Low,High> tan(const Mixed<Low,High>& x)
+{ return x.InLow([](const Low v) { using std::tan; return tan(v); }); }
+
+template<typename Low, std::floating_point High>
+Mixed<Low,High> asin(const Mixed<Low,High>& x)
+{ return x.InLow([](const Low v) { using std::asin; return asin(v); }); }
+
+template<typename Low, std::floating_point High>
+Mixed<Low,High> acos(const Mixed<Low,High>& x)
+{ return x.InLow([](const Low v) { using std::acos; return acos(v); }); }
+
+template<typename Low, std::floating_point High>
+Mixed<Low,High> atan(const Mixed<Low,High>& x)
+{ return x.InLow([](const Low v) { using std::atan; return atan(v); }); }
+
+
+// Value of expr at input, with the elementary functions in Low
+template<typename Low = float, typename SymType, std::floating_point T>
+T EvaluateMixed(const SymbolicBase<SymType>& expr, const T input)
+{
+  return expr.derived().Evaluate(Mixed<Low,T>(input)).Value();
+}
+
+
+} // Symbolic namespace
+#endif
@@ -8,6 +8,14 @@
 #include "symbolic_base.hpp"
 #include "constants.hpp"
 #include "sum.hpp"
+#include "ordering.hpp"
+
+
+// Products with at least this many factors differentiate to a ProductDerivative
+// node instead of expanding the product rule into O(N^2) factors
+#ifndef SYMBOLIC_WIDE_PRODUCT_SIZE
+#define SYMBOLIC_WIDE_PRODUCT_SIZE 5
+#endif
 
 
 namespace SYMBOLIC_NAMESPACE_NAME {
@@ -15,13 +23,18 @@ namespace SYMBOLIC_NAMESPACE_NAME {
 template<class... ExprTypes>
 class TupleProduct;
 
+template<class... ExprTypes>
+class ProductDerivative;
+
 template<class TupleType, std::size_t... I>
 constexpr auto MakeTupleProduct(const TupleType& expr_tuple, const std::index_sequence<I...>)
 {
-  if constexpr (sizeof...(I) == 1) {
+  if constexpr (sizeof...(I) == 0) {
+    return One<>();
+  } else if constexpr (sizeof...(I) == 1) {
     return std::get<I...>(expr_tuple);
   } else {
-    return TupleProduct(std::get<I>(expr_tuple)...);
+    return MakeCanonical<TupleProduct>(std::get<I>(expr_tuple)...);
   }
 }
 
@@ -36,16 +49,16 @@ template<class... ExprTypes>
 class TupleProduct : public SymbolicBase< TupleProduct<ExprTypes...> >
 {
 private:
-  std::tuple<typename BranchType<ExprTypes>::type...> exprs_;
+  [[no_unique_address]] std::tuple<Branch<ExprTypes>...> exprs_;
 
   template<std::size_t N, typename FloatType>
   constexpr FloatType RecursiveEvaluate(const FloatType& input) const
   {
     if constexpr (N == 0) {
-      return std::get<0>(exprs_).Evaluate(input);
+      return std::get<0>(exprs_)->Evaluate(input);
     }
     else {
-      return std::get<N>(exprs_).Evaluate(input) * RecursiveEvaluate<N-1>(input);
+      return std::get<N>(exprs_)->Evaluate(input) * RecursiveEvaluate<N-1>(input);
     }
   }
 
@@ -53,12 +66,12 @@ private:
   constexpr auto RecursiveDerivative() const
   {
     if constexpr (N == 1) {
-      return (std::get<1>(exprs_) * std::get<0>(exprs_).Derivative())
-        + (std::get<1>(exprs_).Derivative() * std::get<0>(exprs_));
+      return (*std::get<1>(exprs_) * std::get<0>(exprs_)->Derivative())
+        + (std::get<1>(exprs_)->Derivative() * *std::get<0>(exprs_));
     }
     else {
-      return (std::get<N>(exprs_) * RecursiveDerivative<N-1>())
-        + ( std::get<N>(exprs_).Derivative() * MakeTupleProduct(exprs_, std::make_index_sequence<N>()) );
+      return (*std::get<N>(exprs_) * RecursiveDerivative<N-1>())
+        + ( std::get<N>(exprs_)->Derivative() * MakeTupleProduct(Elements(), std::make_index_sequence<N>()) );
     }
   }
 
@@ -66,16 +79,19 @@ private:
   std::string sub_str() const
   {
     if constexpr (N == 0) {
-      return std::get<0>(exprs_).str();
+      return std::get<0>(exprs_)->str();
     }
     else {
-      return sub_str<N-1>() + " * " + std::get<N>(exprs_).str();
+      return sub_str<N-1>() + " * " + std::get<N>(exprs_)->str();
     }
   }
 
 public:
   static constexpr bool is_leaf = false;
   static constexpr bool is_dynamic = (ExprTypes::is_dynamic || ...);
+  static constexpr std::size_t size = sizeof...(ExprTypes);
+
+  constexpr TupleProduct() = default;
 
   constexpr TupleProduct(const ExprTypes&... exprs) : exprs_{exprs...}
   {
@@ -99,7 +115,11 @@ public:
 
   constexpr auto Derivative() const
   { 
-    return RecursiveDerivative<(sizeof...(ExprTypes))-1>();
+    if constexpr (sizeof...(ExprTypes) >= SYMBOLIC_WIDE_PRODUCT_SIZE) {
+      return std::make_from_tuple<ProductDerivative<ExprTypes...>>(Elements());
+    } else {
+      return RecursiveDerivative<(sizeof...(ExprTypes))-1>();
+    }
   }
 
   std::string str() const
@@ -107,6 +127,12 @@ public:
     return "(" + sub_str<(sizeof...(ExprTypes))-1>() + ")";
   }
 
+  // Copies of the children, in order
+  constexpr std::tuple<ExprTypes...> Elements() const
+  {
+    return std::apply([](const auto&... exprs) { return std::tuple<ExprTypes...>(*exprs...); }, exprs_);
+  }
+
   template<std::size_t N, class... Exprs>
   friend constexpr auto get(const TupleProduct<Exprs...>& prod);
 
@@ -116,21 +142,21 @@ public:
     static_assert(N < sizeof...(ExprTypes), "TupleProduct::ModifyElement called with invalid index");
     if constexpr (N == (sizeof...(ExprTypes)-1)) {
       return MakeTupleProduct(std::tuple_cat(
-        tuple_slice<0,N>(exprs_),
-        std::make_tuple(std::get<N>(exprs_) * expr.derived())
+        tuple_slice<0,N>(Elements()),
+        std::make_tuple(*std::get<N>(exprs_) * expr.derived())
       ));
     }
     else if constexpr (N == 0) {
       return MakeTupleProduct(std::tuple_cat(
-        std::make_tuple(std::get<N>(exprs_) * expr.derived()),
-        tuple_slice<N+1, sizeof...(ExprTypes)>(exprs_)
+        std::make_tuple(*std::get<N>(exprs_) * expr.derived()),
+        tuple_slice<N+1, sizeof...(ExprTypes)>(Elements())
       ));
     }
     else {
       return MakeTupleProduct(std::tuple_cat(
-        tuple_slice<0,N>(exprs_),
-        std::make_tuple(std::get<N>(exprs_) * expr.derived()),
-        tuple_slice<N+1, sizeof...(ExprTypes)>(exprs_)
+        tuple_slice<0,N>(Elements()),
+        std::make_tuple(*std::get<N>(exprs_) * expr.derived()),
+        tuple_slice<N+1, sizeof...(ExprTypes)>(Elements())
       ));
     }
   }
@@ -158,13 +184,13 @@ public:
       ((Is < sizeof...(ExprTypes)) && ...),
       "TupleProduct::Without<Is...> has at least one index out of range");
     
-    return MakeTupleProduct(exprs_, index_sequence_without<sizeof...(ExprTypes), I, Is...>());
+    return MakeTupleProduct(Elements(), index_sequence_without<sizeof...(ExprTypes), I, Is...>());
   }
 
   template<std::size_t... Is>
   constexpr auto Subset() const
   {
-    return MakeTupleProduct(exprs_, std::index_sequence<Is...>());
+    return MakeTupleProduct(Elements(), std::index_sequence<Is...>());
   }
 
 };
@@ -173,22 +199,132 @@ public:
 template<std::size_t N, class... Exprs>
 constexpr auto get(const TupleProduct<Exprs...>& prod)
 {
-  return std::get<N>(prod.exprs_);
+  return *std::get<N>(prod.exprs_);
 }
 
 
+// Derivative of the product of ExprTypes..., sum_i f_i' * prod_{j != i} f_j.
+// The products of the other factors are shared through prefix and suffix
+// products, so evaluating N factors costs O(N) rather than O(N^2), and the
+// type only holds the factors and their derivatives.
+template<class... ExprTypes>
+class ProductDerivative : public SymbolicBase< ProductDerivative<ExprTypes...> >
+{
+private:
+  static constexpr std::size_t N = sizeof...(ExprTypes);
+
+  [[no_unique_address]] std::tuple<Branch<ExprTypes>...> exprs_;
+  [[no_unique_address]] std::tuple<Branch<decltype(std::declval<ExprTypes>().Derivative())>...> derivatives_;
+
+  // Factors with a zero derivative contribute no term
+  static constexpr bool varies[N] = { !is_zero<decltype(std::declval<ExprTypes>().Derivative())>::value... };
+
+  template<typename FloatType, std::size_t... I>
+  constexpr FloatType EvaluateImpl(const FloatType input, const std::index_sequence<I...>) const
+  {
+    const FloatType values[N] = { std::get<I>(exprs_)->Evaluate(input)... };
+    const FloatType slopes[N] = { (varies[I] ? std::get<I>(derivatives_)->Evaluate(input) : static_cast<FloatType>(0))... };
+
+    FloatType suffix[N+1];
+    suffix[N] = static_cast<FloatType>(1);
+    for (std::size_t i = N; i > 0; --i) {
+      suffix[i-1] = suffix[i] * values[i-1];
+    }
+
+    FloatType prefix = static_cast<FloatType>(1);
+    FloatType result = static_cast<FloatType>(0);
+    for (std::size_t i = 0; i < N; ++i) {
+      if (varies[i]) {
+        result += slopes[i] * prefix * suffix[i+1];
+      }
+      prefix *= values[i];
+    }
+    return result;
+  }
+
+  // d/dx of term I is the derivative of the product with f_I replaced by f_I'
+  template<std::size_t I, std::size_t... J>
+  constexpr auto TermDerivative(const std::index_sequence<J...>) const
+  {
+    if constexpr (!varies[I]) {
+      return Zero<>();
+    } else {
+      return ProductDerivative<std::conditional_t<
+          I == J,
+          decltype(std::declval<ExprTypes>().Derivative()),
+          ExprTypes>...>(
+        [&]() {
+          if constexpr (I == J) {
+            return *std::get<J>(derivatives_);
+          } else {
+            return *std::get<J>(exprs_);
+          }
+        }()...);
+    }
+  }
+
+  template<std::size_t... I>
+  constexpr auto DerivativeImpl(const std::index_sequence<I...> seq) const
+  {
+    return (Zero<>() + ... + TermDerivative<I>(seq));
+  }
+
+  template<std::size_t M>
+  std::string sub_str() const
+  {
+    if constexpr (M == 0) {
+      return std::get<0>(exprs_)->str();
+    }
+    else {
+      return sub_str<M-1>() + " * " + std::get<M>(exprs_)->str();
+    }
+  }
+
+public:
+  static constexpr bool is_leaf = false;
+  static constexpr bool is_dynamic = (ExprTypes::is_dynamic || ...);
+
+  constexpr ProductDerivative() = default;
+
+  constexpr ProductDerivative(const ExprTypes&... exprs)
+    : exprs_{exprs...}, derivatives_{exprs.Derivative()...}
+  {}
+
+  template<typename FloatType>
+  constexpr FloatType Evaluate(const FloatType input) const
+  {
+    return EvaluateImpl(input, std::make_index_sequence<N>());
+  }
+
+  constexpr auto Derivative() const
+  {
+    return DerivativeImpl(std::make_index_sequence<N>());
+  }
+
+  std::string str() const
+  {
+    return "d/dx(" + sub_str<N-1>() + ")";
+  }
+
+  constexpr std::tuple<ExprTypes...> Factors() const
+  {
+    return std::apply([](const auto&... exprs) { return std::tuple<ExprTypes...>(*exprs...); }, exprs_);
+  }
+};
+
+
 template<class TupleType, class SymType, std::size_t... I>
 constexpr auto
 ExtendTupleProductImpl(const TupleType& expr_tuple, const SymbolicBase<SymType>& factor, const std::index_sequence<I...>)
 {
-  return TupleProduct(std::get<I>(expr_tuple)..., factor.derived());
+  return MakeCanonical<TupleProduct>(std::get<I>(expr_tuple)..., factor.derived());
 }
 
 template<class SymType, class... Factors>
 constexpr auto
 ExtendTupleProduct(const TupleProduct<Factors...>& prod, const SymbolicBase<SymType>& factor)
 {
-  return ExtendTupleProductImpl(prod.exprs_, factor.derived(), std::make_index_sequence<sizeof...(Factors)>());
+  return ExtendTupleProductImpl(prod.Elements(), factor.derived(), std::make_index_sequence<sizeof...(Factors)>());
 }
 
 
@@ -196,14 +332,14 @@ template<class TupleType, class SymType, std::size_t... I>
 constexpr auto
 ExtendTupleProductImpl(const SymbolicBase<SymType>& factor, const TupleType& expr_tuple, const std::index_sequence<I...>)
 {
-  return TupleProduct(factor.derived(), std::get<I>(expr_tuple)...);
+  return MakeCanonical<TupleProduct>(factor.derived(), std::get<I>(expr_tuple)...);
 }
 
 template<class SymType, class... Factors>
 constexpr auto
 ExtendTupleProduct(const SymbolicBase<SymType>& factor, const TupleProduct<Factors...>& prod)
 {
-  return ExtendTupleProductImpl(factor.derived(), prod.exprs_, std::make_index_sequence<sizeof...(Factors)>());
+  return ExtendTupleProductImpl(factor.derived(), prod.Elements(), std::make_index_sequence<sizeof...(Factors)>());
 }
 
 
@@ -214,14 +350,14 @@ constexpr auto ExtendTupleProductImpl(
     const std::index_sequence<I1...>,
     const std::index_sequence<I2...>)
 {
-  return TupleProduct(std::get<I1>(expr_tuple1)..., std::get<I2>(expr_tuple2)...);
+  return MakeCanonical<TupleProduct>(std::get<I1>(expr_tuple1)..., std::get<I2>(expr_tuple2)...);
 }
 
 template<class... Sym1, class... Sym2>
 constexpr auto
 ExtendTupleProduct(const TupleProduct<Sym1...>& prod1, const TupleProduct<Sym2...>& prod2)
 {
-  return ExtendTupleProductImpl(prod1.exprs_, prod2.exprs_,
+  return ExtendTupleProductImpl(prod1.Elements(), prod2.Elements(),
     std::make_index_sequence<sizeof...(Sym1)>(),
     std::make_index_sequence<sizeof...(Sym2)>());
 }
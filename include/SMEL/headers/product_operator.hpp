@@ -7,6 +7,7 @@
 #include "metaprogramming.hpp"
 #include "product.hpp"
 #include "constants.hpp"
+#include "hash.hpp"
 #include "negation.hpp"
 // #include "pow.hpp"
 
@@ -80,44 +81,33 @@ struct ProductCombinable < Exponential<Sym1,Sym2>&, Exponential<Sym1,Sym3> >
 };
 
 
+// Products are kept in canonical order, so equal products match element by
+// element. Products of different hashes are told apart without visiting them.
 template<class... Sym1, class... Sym2>
 struct is_same<TupleProduct<Sym1...>,TupleProduct<Sym2...>>
 {
-  template<std::size_t N, size_t M>
-  static constexpr bool find_value_impl()
+  static constexpr bool compare()
   {
-    if constexpr (is_same_v<NthTypeOf<N,Sym1...>,NthTypeOf<M,Sym2...>>) {
-      if constexpr ((N+1) < sizeof...(Sym1)) {
-        return find_value_impl<N+1,0>();
-      }
-      else {
-        return true;
-      }
-    }
-    else {
-      if constexpr ((M+1) < sizeof...(Sym2)) {
-        return find_value_impl<N,M+1>();
-      }
-      else {
-        return false;
-      }
+    if constexpr (sizeof...(Sym1) == sizeof...(Sym2) && hash_match_v<TupleProduct<Sym1...>,TupleProduct<Sym2...>>) {
+      return (is_same_v<Sym1,Sym2> && ...);
+    } else {
+      return false;
     }
   }
 
-  static constexpr bool value = find_value_impl<0,0>();
+  static constexpr bool value = compare();
 };
 
 //TODO power re-distribution
 
-template<std::size_t N, class Sym1, class... Sym2>
+// Merges expr1 into the first factor it combines with, else adds it to the product
+template<class Sym1, class... Sym2>
 constexpr auto extended_product_impl(const SymbolicBase<Sym1>& expr1, const TupleProduct<Sym2...>& expr2)
 {
-  if constexpr (ProductCombinable<Sym1, NthTypeOf<N, Sym2...>>::value) {
+  constexpr std::size_t N = FirstTrue<ProductCombinable<Sym1, Sym2>::value...>();
+  if constexpr (N < sizeof...(Sym2)) {
     return expr2.template ModifyElement<N,Sym1>(expr1.derived());
   }
-  else if constexpr (N+1 < sizeof...(Sym2)) {
-    return extended_product_impl<N+1>(expr1, expr2);
-  }
   else {
     return ExtendTupleProduct(expr1.derived(), expr2);
   }
@@ -126,21 +116,19 @@ constexpr auto extended_product_impl(const SymbolicBase<Sym1>& expr1, const Tupl
 // template<class... Sym1, class Sym2>
 // auto operator*(const TupleProduct<Sym1...>& expr1, const SymbolicBase<Sym2>& expr2)
 // {
-//   return extended_product_impl<0>(expr2.derived(), expr1);
+//   return extended_product_impl(expr2.derived(), expr1);
 // }
 
 // template<class... Sym1, class Sym2>
 // auto operator*(const SymbolicBase<Sym2>& expr1, const TupleProduct<Sym1...>& expr2)
 // {
-//   return extended_product_impl<0>(expr1.derived(), expr2);
+//   return extended_product_impl(expr1.derived(), expr2);
 // }
 
-//TODO x * (1/x) and x^N * (1/x^M) in general function
-//TODO Product * Quotient functions
-//TODO Sum * Quotient functions (sum * (f / g) -> (sum * f) / g)
+// Multiplying by a quotient moves the other factor into its numerator, so that
+// operator/ can cancel it: x * (1/x) -> 1, sum * (f / g) -> (sum * f) / g
 template<class Sym1, class Sym2>
-constexpr auto
-operator*(const SymbolicBase<Sym1>& expr1, const SymbolicBase<Sym2>& expr2)
+constexpr auto ProductImpl(const SymbolicBase<Sym1>& expr1, const SymbolicBase<Sym2>& expr2)
 {
   if constexpr (is_zero_v<Sym1> || is_zero_v<Sym2>) {
     return Zero<>();
@@ -170,77 +158,59 @@ operator*(const SymbolicBase<Sym1>& expr1, const SymbolicBase<Sym2>& expr2)
   else if constexpr (is_negative_constant_v<Sym2>) {
     return -( expr1.derived() * (-expr2.derived()) );
   }
+  else if constexpr (is_quotient_v<Sym1>) {
+    if constexpr (is_quotient_v<Sym2>) {
+      return (expr1.derived().Numerator() * expr2.derived().Numerator())
+        / (expr1.derived().Denominator() * expr2.derived().Denominator());
+    } else {
+      return (expr1.derived().Numerator() * expr2.derived()) / expr1.derived().Denominator();
+    }
+  }
+  else if constexpr (is_quotient_v<Sym2>) {
+    return (expr1.derived() * expr2.derived().Numerator()) / expr2.derived().Denominator();
+  }
   else if constexpr (is_product_v<Sym1>) {
-    return extended_product_impl<0>(expr2, expr1.derived());
+    return extended_product_impl(expr2, expr1.derived());
   }
   else if constexpr (is_product_v<Sym2>) {
-    return extended_product_impl<0>(expr1, expr2.derived());
+    return extended_product_impl(expr1, expr2.derived());
   }
   else {
-    return TupleProduct<Sym1,Sym2>(expr1.derived(), expr2.derived());
+    return MakeCanonical<TupleProduct>(expr1.derived(), expr2.derived());
   }
 }
 
+// Every product built goes through the construction rules, see ConstructionRules
+template<class Sym1, class Sym2>
+constexpr auto
+operator*(const SymbolicBase<Sym1>& expr1, const SymbolicBase<Sym2>& expr2)
+{
+  return ApplyConstructionRules(ProductImpl(expr1, expr2));
+}
+
 
 // Multiplication of TupleProducts
-template<std::size_t N, std::size_t M, std::size_t... I, class... Sym1, class... Sym2>
-constexpr auto 
-merge_products_impl2(const TupleProduct<Sym1...>& expr1, const TupleProduct<Sym2...>& expr2)
+// Factor N of expr1, times the factor of expr2 paired with it
+template<auto Pairs, std::size_t N, class... Sym1, class... Sym2>
+constexpr auto merged_factor(const TupleProduct<Sym1...>& expr1, const TupleProduct<Sym2...>& expr2)
 {
-  if constexpr (ProductCombinable< NthTypeOf<N, Sym1...>, NthTypeOf<M, Sym2...> >::value) {
-    if constexpr ((N+1) < sizeof...(Sym1)) {
-      return merge_products_impl2<N+1, 0, I..., M>(
-        expr1.template ModifyElement<N>(get<M>(expr2)), expr2);
-    }
-    else {
-      return ExtendTupleProduct(
-        expr1.template ModifyElement<N>(get<M>(expr2)), expr2.template Without<I..., M>()
-        );
-    }
-  }
-  else {
-    if constexpr ((M+1) < sizeof...(Sym2)) {
-      return merge_products_impl2<N,M+1,I...>(expr1, expr2);
-    }
-    else {
-      if constexpr ((N+1) < sizeof...(Sym1)) {
-        return merge_products_impl2<N+1,0,I...>(expr1, expr2);
-      }
-      else {
-        return ExtendTupleProduct(expr1, expr2.template Without<I...>());
-      }
-    }
+  constexpr std::size_t K = PairOf<Pairs>(N);
+  if constexpr (K < Pairs.size) {
+    return get<N>(expr1) * get<Pairs.second[K]>(expr2);
+  } else {
+    return get<N>(expr1);
   }
 }
 
-template<std::size_t N, std::size_t M, class... Sym1, class... Sym2>
-constexpr auto
-merge_products_impl1(const TupleProduct<Sym1...>& expr1, const TupleProduct<Sym2...>& expr2)
+// Every factor of expr1, merged with its pair, then the unpaired factors M... of expr2
+template<auto Pairs, class... Sym1, class... Sym2, std::size_t... N, std::size_t... M>
+constexpr auto merge_products_impl(
+  const TupleProduct<Sym1...>& expr1,
+  const TupleProduct<Sym2...>& expr2,
+  const std::index_sequence<N...>,
+  const std::index_sequence<M...>)
 {
-  if constexpr (ProductCombinable< NthTypeOf<N, Sym1...>, NthTypeOf<M, Sym2...> >::value) {
-    if constexpr ((N+1) < sizeof...(Sym1)) {
-      return merge_products_impl2<N+1, 0, M>(
-        expr1.template ModifyElement<N>(get<M>(expr2)), expr2);
-    }
-    else {
-      return ExtendTupleProduct(
-        expr1.template ModifyElement<N>(get<M>(expr2)), expr2.template Without<M>()
-        );
-    }
-  }
-  else {
-    if constexpr ((M+1) < sizeof...(Sym2)) {
-      return merge_products_impl1<N,M+1>(expr1, expr2);
-    }
-    else {
-      if constexpr ((N+1) < sizeof...(Sym1)) {
-        return merge_products_impl1<N+1,0>(expr1, expr2);
-      }
-      else {
-        return ExtendTupleProduct(expr1, expr2);
-      }
-    }
-  }
+  return MakeTupleProduct(std::make_tuple(merged_factor<Pairs,N>(expr1, expr2)..., get<M>(expr2)...));
 }
 
 template<class... Sym1, class... Sym2>
@@ -250,7 +220,11 @@ operator*(const TupleProduct<Sym1...>& expr1, const TupleProduct<Sym2...>& expr2
   if constexpr (is_same_v<TupleProduct<Sym1...>,TupleProduct<Sym2...>>) {
     return pow<2>(expr1);
   } else {
-    return merge_products_impl1<0,0>(expr1,expr2);
+    // each factor of expr1 combines with the first free factor of expr2 it can
+    constexpr auto pairs = greedy_pairs_v<ProductCombinable, type_list<Sym1...>, type_list<Sym2...>>;
+    return ApplyConstructionRules(merge_products_impl<pairs>(expr1, expr2,
+      std::index_sequence_for<Sym1...>(),
+      index_sequence_without<sizeof...(Sym2)>(second_indices_t<pairs>())));
   }
   // return TupleProduct(expr1,expr2);
 }
@@ -0,0 +1,290 @@
+#ifndef SYMBOLIC_INCLUDE_PROFILE_HPP
+#define SYMBOLIC_INCLUDE_PROFILE_HPP
+
+#include <deque>
+#include <tuple>
+#include <cmath>
+#include <chrono>
+#include <limits>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "symbolic_base.hpp"
+#include "prototyping.hpp"
+#include "structure.hpp"
+#include "cost.hpp"
+
+
+// Instrument() wraps every node in a Profiled counter when this is nonzero, and
+// returns the expression unchanged otherwise
+#ifndef SYMBOLIC_ENABLE_PROFILING
+#define SYMBOLIC_ENABLE_PROFILING 0
+#endif
+
+
+namespace SYMBOLIC_NAMESPACE_NAME {
+
+// Time stamp counter where available, nanoseconds of the steady clock elsewhere.
+// The builtin spares every includer the intrinsics headers.
+inline std::uint64_t ProfileTicks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_ia32_rdtsc();
+#else
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Ticks of ProfileTicks per second, measured once against the steady clock
+inline double ProfileTicksPerSecond()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  static const double rate = []() {
+    typedef std::chrono::steady_clock Clock;
+    const auto start = Clock::now();
+    const std::uint64_t ticks = ProfileTicks();
+    while (Clock::now() - start < std::chrono::milliseconds(20)) {}
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return static_cast<double>(ProfileTicks() - ticks) / seconds;
+  }();
+  return rate;
+#else
+  return 1e9;
+#endif
+}
+
+
+// Counters of one instrumented node. total includes the children and the
+// overhead of their own counters.
+struct ProfileCounters
+{
+  std::string name;
+  std::size_t parent;
+  std::vector<std::size_t> children;
+  std::uint64_t calls = 0;
+  std::uint64_t ticks = 0;
+  std::uint64_t nans = 0;
+  std::uint64_t infs = 0;
+};
+
+// Counters of every node of the expressions passed to Instrument, in pre-order.
+// Not thread-safe: evaluate an instrumented expression on one thread at a time.
+class EvaluationProfile
+{
+private:
+  std::deque<ProfileCounters> nodes_;  // stable addresses for Profiled
+
+  static std::string Shorten(const std::string& name, const std::size_t width)
+  {
+    return name.size() <= width ? name : name.substr(0, width - 3) + "...";
+  }
+
+  static std::string Escape(const std::string& text)
+  {
+    std::string out;
+    for (const char c : text) {
+      if (c == '"' || c == '\\') {
+        out += '\\';
+      }
+      out += c;
+    }
+    return out;
+  }
+
+  void Line(std::string& out, const std::size_t i, const std::size_t depth, const std::size_t width) const
+  {
+    const ProfileCounters& node = nodes_[i];
+    const double us_per_tick = 1e6 / ProfileTicksPerSecond();
+    char buffer[96];
+    std::snprintf(buffer, sizeof(buffer), "%12.1f %12.1f %12llu %8llu %8llu  ",
+      static_cast<double>(node.ticks) * us_per_tick, static_cast<double>(SelfTicks(i)) * us_per_tick,
+      static_cast<unsigned long long>(node.calls),
+      static_cast<unsigned long long>(node.nans), static_cast<unsigned long long>(node.infs));
+    out += buffer + std::string(2 * depth, ' ') + Shorten(node.name, width) + "\n";
+    for (const std::size_t child : node.children) {
+      Line(out, child, depth + 1, width);
+    }
+  }
+
+  // Complete events laid out as a flame graph: each child starts where its
+  // previous sibling ends, inside its parent
+  void Events(std::string& out, const std::size_t i, const double start) const
+  {
+    const ProfileCounters& node = nodes_[i];
+    const double us_per_tick = 1e6 / ProfileTicksPerSecond();
+    char buffer[160];
+    std::snprintf(buffer, sizeof(buffer),
+      "\", \"ph\": \"X\", \"pid\": 0, \"tid\": 0, \"ts\": %.3f, \"dur\": %.3f, "
+      "\"args\": {\"calls\": %llu, \"self_us\": %.3f, \"nans\": %llu, \"infs\": %llu}}",
+      start, static_cast<double>(node.ticks) * us_per_tick,
+      static_cast<unsigned long long>(node.calls), static_cast<double>(SelfTicks(i)) * us_per_tick,
+      static_cast<unsigned long long>(node.nans), static_cast<unsigned long long>(node.infs));
+    out += std::string(out.back() == '[' ? "\n" : ",\n") + "    {\"name\": \"" + Escape(node.name) + buffer;
+    double child_start = start;
+    for (const std::size_t child : node.children) {
+      Events(out, child, child_start);
+      child_start += static_cast<double>(nodes_[child].ticks) * us_per_tick;
+    }
+  }
+
+public:
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  EvaluationProfile() = default;
+  EvaluationProfile(const EvaluationProfile&) = delete;
+  EvaluationProfile& operator=(const EvaluationProfile&) = delete;
+
+  ProfileCounters& Add(std::string name, const std::size_t parent)
+  {
+    if (parent != npos) {
+      nodes_[parent].children.push_back(nodes_.size());
+    }
+    ProfileCounters& node = nodes_.emplace_back();
+    node.name = std::move(name);
+    node.parent = parent;
+    return node;
+  }
+
+  std::size_t Size() const
+  { return nodes_.size(); }
+
+  const ProfileCounters& operator[](const std::size_t i) const
+  { return nodes_[i]; }
+
+  // Ticks of node i not spent in its instrumented children
+  std::uint64_t SelfTicks(const std::size_t i) const
+  {
+    std::uint64_t children = 0;
+    for (const std::size_t child : nodes_[i].children) {
+      children += nodes_[child].ticks;
+    }
+    return nodes_[i].ticks > children ? nodes_[i].ticks - children : 0;
+  }
+
+  // Zeroes the counters, keeping the nodes
+  void Reset()
+  {
+    for (ProfileCounters& node : nodes_) {
+      node.calls = node.ticks = node.nans = node.infs = 0;
+    }
+  }
+
+  // One line per node, indented under its parent, with times in microseconds
+  std::string Report(const std::size_t width = 80) const
+  {
+    if (!SYMBOLIC_ENABLE_PROFILING) {
+      return "profiling disabled, define SYMBOLIC_ENABLE_PROFILING=1\n";
+    }
+    std::string out = "    total us      self us        calls     nans     infs  node\n";
+    for (std::size_t i = 0; i < nodes_.size(); ++i) {
+      if (nodes_[i].parent == npos) {
+        Line(out, i, 0, width);
+      }
+    }
+    return out;
+  }
+
+  // Chrome trace event JSON (chrome://tracing, Perfetto) of the same tree
+  std::string ChromeTrace() const
+  {
+    std::string out = "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    double start = 0;
+    for (std::size_t i = 0; i < nodes_.size(); ++i) {
+      if (nodes_[i].parent == npos) {
+        Events(out, i, start);
+        start += static_cast<double>(nodes_[i].ticks) * 1e6 / ProfileTicksPerSecond();
+      }
+    }
+    return out + "\n]}\n";
+  }
+};
+
+
+// A node counting the calls, time and non-finite results of its Evaluate
+template<typename SymType>
+class Profiled : public SymbolicBase< Profiled<SymType> >
+{
+private:
+  SymType expr_;
+  ProfileCounters* counters_;
+
+public:
+  static constexpr bool is_leaf = false;
+  static constexpr bool is_dynamic = true;
+
+  Profiled(const SymType& expr, ProfileCounters* counters) : expr_{expr}, counters_{counters}
+  {}
+
+  template<typename FloatType>
+  FloatType Evaluate(const FloatType input) const
+  {
+    const std::uint64_t start = ProfileTicks();
+    const FloatType value = expr_.Evaluate(input);
+    counters_->ticks += ProfileTicks() - start;
+    ++counters_->calls;
+    if constexpr (std::numeric_limits<FloatType>::has_quiet_NaN) {
+      counters_->nans += std::isnan(value);
+      counters_->infs += std::isinf(value);
+    }
+    return value;
+  }
+
+  // Derivatives of instrumented children keep counting into the same nodes
+  auto Derivative() const
+  {
+    return expr_.Derivative();
+  }
+
+  std::string str() const
+  {
+    return expr_.str();
+  }
+
+  const SymType& Expression() const
+  { return expr_; }
+};
+
+// Opaque to Children/Rebuild, measured as the node it wraps
+template<typename SymType>
+struct node_children<Profiled<SymType>>
+{
+  typedef type_list<> type;
+};
+
+template<typename SymType>
+struct cost_node<Profiled<SymType>>
+{
+  typedef cost_node_t<SymType> type;
+};
+
+
+// expr with every node that has children wrapped in a Profiled counting into
+// profile, which must outlive the result. Leaves are not wrapped: reading one
+// costs less than the counter. Without SYMBOLIC_ENABLE_PROFILING, expr itself.
+template<typename SymType>
+auto Instrument(const SymbolicBase<SymType>& expr, EvaluationProfile& profile,
+  const std::size_t parent = EvaluationProfile::npos)
+{
+  if constexpr (!SYMBOLIC_ENABLE_PROFILING || node_children_t<SymType>::size == 0) {
+    return expr.derived();
+  }
+  else {
+    ProfileCounters& counters = profile.Add(expr.str(), parent);
+    const std::size_t index = profile.Size() - 1;
+    // braced initialization instruments the children in order
+    const auto children = std::apply([&](const auto&... child) {
+      return std::tuple{ Instrument(child, profile, index)... };
+    }, Children(expr));
+    const auto node = std::apply([&](const auto&... child) { return Rebuild(expr, child...); }, children);
+    return Profiled<std::remove_cvref_t<decltype(node)>>(node, &counters);
+  }
+}
+
+
+} // Symbolic namespace
+#endif
@@ -15,6 +15,9 @@ class TupleSum;
 template<class... ExprTypes>
 class TupleProduct;
 
+template<class... ExprTypes>
+class ProductDerivative;
+
 template<typename NumExpr, typename DenExpr>
 class Quotient;
 
@@ -66,5 +69,14 @@ class ArcCotangent;
 template<typename SymType>
 class ArcCosecant;
 
+template<typename SymType>
+class Interned;
+
+template<typename SymType>
+struct is_zero;
+
+template<typename SymType>
+constexpr auto ApplyConstructionRules(const SymType& expr);
+
 } // Symbolic namespace
 #endif
\ No newline at end of file
@@ -0,0 +1,385 @@
+#ifndef SYMBOLIC_INCLUDE_QUADRATURE_HPP
+#define SYMBOLIC_INCLUDE_QUADRATURE_HPP
+
+#include <span>
+#include <cmath>
+#include <array>
+#include <limits>
+#include <thread>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <numbers>
+#include <algorithm>
+#include <concepts>
+#include <type_traits>
+
+#include "symbolic_base.hpp"
+
+
+namespace SYMBOLIC_NAMESPACE_NAME {
+
+enum class QuadratureRule { GaussKronrod, TanhSinh };
+
+
+// Gauss-Kronrod 7/15 point rule on [-1,1], positive half of the nodes.
+// Odd indices of the Kronrod nodes are the Gauss nodes, so the embedded
+// Gauss estimate reuses the Kronrod function values.
+template<typename FloatType>
+struct GaussKronrod15
+{
+  static constexpr std::array<FloatType,8> nodes {
+    static_cast<FloatType>(0.991455371120812639206854697526329L),
+    static_cast<FloatType>(0.949107912342758524526189684047851L),
+    static_cast<FloatType>(0.864864423359769072789712788640926L),
+    static_cast<FloatType>(0.741531185599394439863864773280788L),
+    static_cast<FloatType>(0.586087235467691130294144845693013L),
+    static_cast<FloatType>(0.405845151377397166906606412076961L),
+    static_cast<FloatType>(0.207784955007898467600689403773245L),
+    static_cast<FloatType>(0.0L)
+  };
+
+  static constexpr std::array<FloatType,8> kronrod_weights {
+    static_cast<FloatType>(0.022935322010529224963732008058970L),
+    static_cast<FloatType>(0.063092092629978553290700663189204L),
+    static_cast<FloatType>(0.104790010322250183839876322541518L),
+    static_cast<FloatType>(0.140653259715525918745189590510238L),
+    static_cast<FloatType>(0.169004726639267902826583426598550L),
+    static_cast<FloatType>(0.190350578064785409913256402421014L),
+    static_cast<FloatType>(0.204432940075298892414161999234649L),
+    static_cast<FloatType>(0.209482141084727828012999174891714L)
+  };
+
+  static constexpr std::array<FloatType,4> gauss_weights {
+    static_cast<FloatType>(0.129484966168869693270611432679082L),
+    static_cast<FloatType>(0.279705391489276667901467771423780L),
+    static_cast<FloatType>(0.381830050505118944950369775488975L),
+    static_cast<FloatType>(0.417959183673469387755102040816327L)
+  };
+};
+
+
+// Value of an integral with its estimated absolute error. converged is false
+// when the rule ran out of panels or levels before the error met the tolerance,
+// including when the estimate is not finite.
+template<typename FloatType>
+struct QuadratureResult
+{
+  FloatType value;
+  FloatType error;
+  bool converged;
+};
+
+
+template<typename FloatType>
+struct QuadraturePanel
+{
+  FloatType a;
+  FloatType b;
+  FloatType value;
+  FloatType error;
+};
+
+
+// Evaluates all 15 nodes of the panel in one batch before reducing them
+template<typename SymType, typename FloatType>
+QuadraturePanel<FloatType> GaussKronrodPanel(const SymType& expr, const FloatType a, const FloatType b)
+{
+  typedef GaussKronrod15<FloatType> Rule;
+  const FloatType center = (a + b) / static_cast<FloatType>(2);
+  const FloatType half = (b - a) / static_cast<FloatType>(2);
+
+  std::array<FloatType,15> f;
+  for (std::size_t i = 0; i < 7; ++i) {
+    f[i] = expr.Evaluate(center - half * Rule::nodes[i]);
+    f[14-i] = expr.Evaluate(center + half * Rule::nodes[i]);
+  }
+  f[7] = expr.Evaluate(center);
+
+  FloatType kronrod = Rule::kronrod_weights[7] * f[7];
+  FloatType gauss = Rule::gauss_weights[3] * f[7];
+  for (std::size_t i = 0; i < 7; ++i) {
+    const FloatType pair = f[i] + f[14-i];
+    kronrod += Rule::kronrod_weights[i] * pair;
+    if (i % 2 == 1) {
+      gauss += Rule::gauss_weights[i/2] * pair;
+    }
+  }
+
+  return { a, b, kronrod * half, std::abs((kronrod - gauss) * half) };
+}
+
+
+// Panels are bisected rather than refined in place: the 15 nodes of a half
+// panel fall between those of the whole one, so no function value carries over
+// from one level to the next
+template<typename SymType, typename FloatType>
+QuadratureResult<FloatType> IntegrateGaussKronrod(
+  const SymType& expr,
+  const FloatType a,
+  const FloatType b,
+  const FloatType tol,
+  const std::size_t max_panels)
+{
+  if (a == b) {
+    return { static_cast<FloatType>(0), static_cast<FloatType>(0), true };
+  }
+
+  auto worse = [](const QuadraturePanel<FloatType>& p1, const QuadraturePanel<FloatType>& p2)
+    { return p1.error < p2.error; };
+
+  std::vector<QuadraturePanel<FloatType>> panels;
+  panels.reserve(max_panels);
+  panels.push_back(GaussKronrodPanel(expr, a, b));
+  FloatType value = panels.front().value;
+  FloatType error = panels.front().error;
+
+  // Always bisect the panel with the largest error estimate
+  while (!(error <= tol) && (panels.size() < max_panels)) {
+    std::pop_heap(panels.begin(), panels.end(), worse);
+    const QuadraturePanel<FloatType> worst = panels.back();
+    panels.pop_back();
+
+    const FloatType mid = (worst.a + worst.b) / static_cast<FloatType>(2);
+    const auto left = GaussKronrodPanel(expr, worst.a, mid);
+    const auto right = GaussKronrodPanel(expr, mid, worst.b);
+    value += (left.value + right.value) - worst.value;
+    error += (left.error + right.error) - worst.error;
+
+    panels.push_back(left);
+    std::push_heap(panels.begin(), panels.end(), worse);
+    panels.push_back(right);
+    std::push_heap(panels.begin(), panels.end(), worse);
+  }
+
+  // Re-sum to get rid of the drift from the running updates
+  value = error = static_cast<FloatType>(0);
+  for (const auto& panel : panels) {
+    value += panel.value;
+    error += panel.error;
+  }
+  return { value, error, error <= tol };
+}
+
+
+// Tanh-sinh abscissas and weights on [-1,1] for every refinement level. Each
+// level only stores the nodes that are new at that level, so refining reuses
+// all previously computed function values. Build once and share between calls.
+template<typename FloatType>
+class TanhSinhTable
+{
+public:
+  struct Node
+  {
+    FloatType complement; // 1 - |abscissa|, kept separately to avoid cancellation at the endpoints
+    FloatType weight;
+  };
+
+  explicit TanhSinhTable(const std::size_t max_level = 8)
+    : levels_(max_level + 1)
+  {
+    constexpr FloatType half_pi = std::numbers::pi_v<FloatType> / static_cast<FloatType>(2);
+    for (std::size_t level = 0; level <= max_level; ++level) {
+      const FloatType h = std::ldexp(static_cast<FloatType>(1), -static_cast<int>(level));
+      const std::size_t stride = (level == 0) ? 1 : 2;
+      for (std::size_t k = (level == 0) ? 0 : 1; ; k += stride) {
+        const FloatType t = static_cast<FloatType>(k) * h;
+        const FloatType u = half_pi * std::sinh(t);
+        const FloatType cosh_u = std::cosh(u);
+        const FloatType complement = static_cast<FloatType>(1) / (std::exp(u) * cosh_u);
+        const FloatType weight = half_pi * std::cosh(t) / (cosh_u * cosh_u);
+        if ((complement < std::numeric_limits<FloatType>::min()) || (weight < std::numeric_limits<FloatType>::min())) {
+          break;
+        }
+        levels_[level].push_back({ complement, weight });
+      }
+    }
+  }
+
+  std::size_t MaxLevel() const
+  { return levels_.size() - 1; }
+
+  const std::vector<Node>& Level(const std::size_t level) const
+  { return levels_[level]; }
+
+private:
+  std::vector<std::vector<Node>> levels_;
+};
+
+
+template<typename SymType, typename FloatType>
+QuadratureResult<FloatType> IntegrateTanhSinh(
+  const SymType& expr,
+  const FloatType a,
+  const FloatType b,
+  const FloatType tol,
+  const TanhSinhTable<FloatType>& table)
+{
+  if (a == b) {
+    return { static_cast<FloatType>(0), static_cast<FloatType>(0), true };
+  }
+
+  const FloatType half = (b - a) / static_cast<FloatType>(2);
+  std::vector<FloatType> f;
+
+  // Sum of weight * f over the nodes new to a level, evaluated as one batch
+  auto level_sum = [&](const std::size_t level) {
+    const auto& nodes = table.Level(level);
+    f.resize(2 * nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+      const FloatType offset = half * nodes[i].complement;
+      f[2*i] = expr.Evaluate(a + offset);
+      f[2*i + 1] = (nodes[i].complement == static_cast<FloatType>(1)) ? static_cast<FloatType>(0) : expr.Evaluate(b - offset);
+    }
+    // Only an infinity at a node that rounded onto its endpoint is dropped: the
+    // endpoint singularity itself. NaN and interior infinities stay in the sum
+    // so the result does not converge.
+    FloatType sum = static_cast<FloatType>(0);
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+      const FloatType offset = half * nodes[i].complement;
+      const FloatType left = (std::isinf(f[2*i]) && (a + offset == a)) ? static_cast<FloatType>(0) : f[2*i];
+      const FloatType right = (std::isinf(f[2*i + 1]) && (b - offset == b)) ? static_cast<FloatType>(0) : f[2*i + 1];
+      sum += nodes[i].weight * (left + right);
+    }
+    return sum;
+  };
+
+  // The change from one level to the next estimates the error
+  FloatType h = static_cast<FloatType>(1);
+  FloatType sum = level_sum(0);
+  FloatType estimate = h * sum * half;
+  FloatType error = std::numeric_limits<FloatType>::infinity();
+  for (std::size_t level = 1; level <= table.MaxLevel(); ++level) {
+    h /= static_cast<FloatType>(2);
+    sum += level_sum(level);
+    const FloatType refined = h * sum * half;
+    error = std::abs(refined - estimate);
+    estimate = refined;
+    if (error <= tol) {
+      break;
+    }
+  }
+  return { estimate, error, error <= tol };
+}
+
+
+// Adaptive integration of expr over [a,b] to an absolute tolerance of tol,
+// with the final error estimate and whether it met tol
+template<QuadratureRule Rule = QuadratureRule::GaussKronrod, typename SymType, std::floating_point FloatType>
+QuadratureResult<FloatType> IntegrateWithError(
+  const SymbolicBase<SymType>& expr,
+  const FloatType a,
+  const std::type_identity_t<FloatType> b,
+  const std::type_identity_t<FloatType> tol,
+  const std::size_t max_panels = 2048)
+{
+  if constexpr (Rule == QuadratureRule::TanhSinh) {
+    return IntegrateTanhSinh(expr.derived(), a, b, tol, TanhSinhTable<FloatType>());
+  } else {
+    return IntegrateGaussKronrod(expr.derived(), a, b, tol, max_panels);
+  }
+}
+
+// Adaptive integration of expr over [a,b] to an absolute tolerance of tol. The
+// value is returned even when tol was not met; see IntegrateWithError.
+template<QuadratureRule Rule = QuadratureRule::GaussKronrod, typename SymType, std::floating_point FloatType>
+FloatType Integrate(
+  const SymbolicBase<SymType>& expr,
+  const FloatType a,
+  const std::type_identity_t<FloatType> b,
+  const std::type_identity_t<FloatType> tol,
+  const std::size_t max_panels = 2048)
+{
+  return IntegrateWithError<Rule>(expr, a, b, tol, max_panels).value;
+}
+
+
+// Integrates one expression over many intervals [a[i],b[i]], sharing the rule setup
+template<QuadratureRule Rule = QuadratureRule::GaussKronrod, typename SymType, std::floating_point FloatType>
+void Integrate(
+  const SymbolicBase<SymType>& expr,
+  const std::type_identity_t<std::span<const FloatType>> a,
+  const std::type_identity_t<std::span<const FloatType>> b,
+  const std::type_identity_t<std::span<QuadratureResult<FloatType>>> out,
+  const FloatType tol,
+  const std::size_t max_panels = 2048)
+{
+  assert(a.size() == b.size());
+  assert(out.size() >= a.size());
+  if constexpr (Rule == QuadratureRule::TanhSinh) {
+    const TanhSinhTable<FloatType> table;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+      out[i] = IntegrateTanhSinh(expr.derived(), a[i], b[i], tol, table);
+    }
+  } else {
+    for (std::size_t i = 0; i < a.size(); ++i) {
+      out[i] = IntegrateGaussKronrod(expr.derived(), a[i], b[i], tol, max_panels);
+    }
+  }
+}
+
+
+// Integrates several expressions over the same interval in one call
+template<QuadratureRule Rule = QuadratureRule::GaussKronrod, std::floating_point FloatType, typename... SymTypes>
+std::array<QuadratureResult<FloatType>, sizeof...(SymTypes)> IntegrateEach(
+  const FloatType a,
+  const std::type_identity_t<FloatType> b,
+  const std::type_identity_t<FloatType> tol,
+  const SymbolicBase<SymTypes>&... exprs)
+{
+  if constexpr (Rule == QuadratureRule::TanhSinh) {
+    const TanhSinhTable<FloatType> table;
+    return { IntegrateTanhSinh(exprs.derived(), a, b, tol, table)... };
+  } else {
+    return { IntegrateGaussKronrod(exprs.derived(), a, b, tol, 2048)... };
+  }
+}
+
+
+// Splits [a,b] into equal subintervals integrated on separate threads. The
+// tolerance is divided evenly so the total error bound still holds; the result
+// has converged only if every subinterval has.
+template<QuadratureRule Rule = QuadratureRule::GaussKronrod, typename SymType, std::floating_point FloatType>
+QuadratureResult<FloatType> IntegrateParallel(
+  const SymbolicBase<SymType>& expr,
+  const FloatType a,
+  const std::type_identity_t<FloatType> b,
+  const std::type_identity_t<FloatType> tol,
+  std::size_t n_threads = std::thread::hardware_concurrency(),
+  const std::size_t max_panels = 2048)
+{
+  n_threads = std::max<std::size_t>(n_threads, 1);
+  const FloatType width = (b - a) / static_cast<FloatType>(n_threads);
+  const FloatType sub_tol = tol / static_cast<FloatType>(n_threads);
+
+  TanhSinhTable<FloatType> table(Rule == QuadratureRule::TanhSinh ? 8 : 0);
+  std::vector<QuadratureResult<FloatType>> partial(n_threads);
+  std::vector<std::thread> threads;
+  threads.reserve(n_threads);
+  for (std::size_t i = 0; i < n_threads; ++i) {
+    threads.emplace_back([&, i]() {
+      const FloatType lo = a + width * static_cast<FloatType>(i);
+      const FloatType hi = (i + 1 == n_threads) ? b : a + width * static_cast<FloatType>(i + 1);
+      if constexpr (Rule == QuadratureRule::TanhSinh) {
+        partial[i] = IntegrateTanhSinh(expr.derived(), lo, hi, sub_tol, table);
+      } else {
+        partial[i] = IntegrateGaussKronrod(expr.derived(), lo, hi, sub_tol, max_panels);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  QuadratureResult<FloatType> result { static_cast<FloatType>(0), static_cast<FloatType>(0), true };
+  for (const auto& p : partial) {
+    result.value += p.value;
+    result.error += p.error;
+    result.converged = result.converged && p.converged;
+  }
+  return result;
+}
+
+
+} // Symbolic namespace
+#endif
@@ -10,13 +10,15 @@ template<typename NumExpr, typename DenExpr>
 class Quotient : public SymbolicBase< Quotient<NumExpr,DenExpr> >
 {
 private:
-  typename std::conditional_t<NumExpr::is_leaf, const NumExpr&, const NumExpr> num_;
-  typename std::conditional_t<DenExpr::is_leaf, const DenExpr&, const DenExpr> den_;
+  [[no_unique_address]] Branch<NumExpr> num_;
+  [[no_unique_address]] Branch<DenExpr> den_;
 
 public:
   static constexpr bool is_leaf = false;
   static constexpr bool is_dynamic = NumExpr::is_dynamic || DenExpr::is_dynamic;
 
+  constexpr Quotient() = default;
+
   constexpr Quotient(const NumExpr& num, const DenExpr& den)
     : num_{num}, den_{den}
   {
@@ -26,17 +28,27 @@ public:
   template<typename FloatType>
   constexpr FloatType Evaluate(const FloatType input) const
   { 
-    return num_.Evaluate(input) / den_.Evaluate(input);
+    return num_->Evaluate(input) / den_->Evaluate(input);
   }
 
   constexpr auto Derivative() const
   {
-    return ( (num_.Derivative() * den_) - (num_ * den_.Derivative()) ) / (den_ * den_); //TODO change to pow<2>
+    return ( (num_->Derivative() * *den_) - (*num_ * den_->Derivative()) ) / (*den_ ^ Int<2>());
   }
 
   std::string str() const
   {
-    return "(" + num_.str() + " / " + den_.str() + ")";
+    return "(" + num_->str() + " / " + den_->str() + ")";
+  }
+
+  constexpr auto Numerator() const
+  {
+    return *num_;
+  }
+
+  constexpr auto Denominator() const
+  {
+    return *den_;
   }
 };
 
@@ -1,29 +1,243 @@
 #ifndef SYMBOLIC_INCLUDE_QUOTIENT_OPERATOR_HPP
 #define SYMBOLIC_INCLUDE_QUOTIENT_OPERATOR_HPP
 
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
 #include "prototyping.hpp"
 #include "type_deductions.hpp"
+#include "product.hpp"
 
 
 namespace SYMBOLIC_NAMESPACE_NAME {
 
-//TODO try cancellation if either is a product
-//TODO cancellation of powers: x^2 / x^3
+// FACTORS
+// A quotient is normalized by viewing its numerator and denominator as lists of
+// factors base^exponent, where anything that isn't an Exponential has exponent 1
+template<typename SymType>
+struct factor_base
+{
+  typedef SymType type;
+};
+
+template<typename Base, typename Exponent>
+struct factor_base<Exponential<Base,Exponent>>
+{
+  typedef Base type;
+};
+
+template<typename SymType>
+using factor_base_t = typename factor_base<SymType>::type;
+
+// Compile-time numbers, which cancel by division rather than by exponents. They
+// only match each other: e^x has base e, but e^x / e must not divide e^x by e.
+template<typename SymType>
+constexpr bool is_static_coefficient_v = is_numeric_coefficient_v<SymType> && zero_derivative_v<SymType>;
+
 template<typename Sym1, typename Sym2>
-constexpr auto
-operator/(const SymbolicBase<Sym1>& expr1, const SymbolicBase<Sym2>& expr2)
+constexpr bool factors_match_v =
+  (is_static_coefficient_v<Sym1> || is_static_coefficient_v<Sym2>)
+  ? (is_static_coefficient_v<Sym1> && is_static_coefficient_v<Sym2>)
+  : is_same_v<factor_base_t<Sym1>, factor_base_t<Sym2>>;
+
+template<typename SymType>
+constexpr auto FactorBase(const SymbolicBase<SymType>& factor)
+{
+  if constexpr (is_exponential_v<SymType>) {
+    return factor.derived().Base();
+  } else {
+    return factor.derived();
+  }
+}
+
+template<typename SymType>
+constexpr auto FactorExponent(const SymbolicBase<SymType>& factor)
+{
+  if constexpr (is_exponential_v<SymType>) {
+    return factor.derived().Exponent();
+  } else {
+    return One<>();
+  }
+}
+
+template<class... Syms, std::size_t... I>
+constexpr auto FactorTupleImpl(const TupleProduct<Syms...>& prod, const std::index_sequence<I...>)
+{
+  return std::make_tuple(get<I>(prod)...);
+}
+
+template<typename SymType>
+constexpr auto FactorTuple(const SymbolicBase<SymType>& expr)
+{
+  if constexpr (is_product_v<SymType>) {
+    return FactorTupleImpl(expr.derived(), std::make_index_sequence<SymType::size>());
+  } else {
+    return std::make_tuple(expr.derived());
+  }
+}
+
+template<class TupleType, std::size_t... I>
+constexpr auto ProductOfFactorsImpl(const TupleType& factors, const std::index_sequence<I...>)
+{
+  return (One<>() * ... * std::get<I>(factors));
+}
+
+template<class TupleType>
+constexpr auto ProductOfFactors(const TupleType& factors)
+{
+  return ProductOfFactorsImpl(factors, std::make_index_sequence<std::tuple_size_v<TupleType>>());
+}
+
+template<std::size_t N, class TupleType, std::size_t... I>
+constexpr auto TupleWithoutImpl(const TupleType& factors, const std::index_sequence<I...>)
+{
+  return std::make_tuple(std::get<(I < N) ? I : I+1>(factors)...);
+}
+
+template<std::size_t N, class TupleType>
+constexpr auto TupleWithout(const TupleType& factors)
+{
+  return TupleWithoutImpl<N>(factors, std::make_index_sequence<std::tuple_size_v<TupleType> - 1>());
+}
+
+template<std::size_t N, class TupleType, class SymType, std::size_t... I>
+constexpr auto TupleReplaceImpl(const TupleType& factors, const SymType& factor, const std::index_sequence<I...>)
+{
+  return std::make_tuple([&]() {
+    if constexpr (I == N) {
+      return factor;
+    } else {
+      return std::get<I>(factors);
+    }
+  }()...);
+}
+
+template<std::size_t N, class TupleType, class SymType>
+constexpr auto TupleReplace(const TupleType& factors, const SymType& factor)
+{
+  return TupleReplaceImpl<N>(factors, factor, std::make_index_sequence<std::tuple_size_v<TupleType>>());
+}
+
+
+// Position of the first factor in TupleType matching SymType, or its size if none
+template<class SymType, class TupleType>
+struct matching_factor;
+
+template<class SymType, class... Factors>
+struct matching_factor<SymType, std::tuple<Factors...>>
+{
+  static constexpr std::size_t find()
+  {
+    constexpr bool matches[] = { factors_match_v<Factors,SymType>..., false };
+    std::size_t index = 0;
+    while (index < sizeof...(Factors) && !matches[index]) {
+      ++index;
+    }
+    return index;
+  }
+
+  static constexpr std::size_t value = find();
+};
+
+template<class NumTuple, class DenTuple>
+struct shares_factor;
+
+template<class NumTuple, class... DenFactors>
+struct shares_factor<NumTuple, std::tuple<DenFactors...>>
+{
+  static constexpr bool value =
+    ((matching_factor<DenFactors,NumTuple>::value < std::tuple_size_v<NumTuple>) || ...);
+};
+
+
+// Cancels every factor of den, starting at position J, against the numerator
+template<std::size_t J, class NumTuple, class DenTuple>
+constexpr auto CancelFactors(const NumTuple& num, const DenTuple& den)
+{
+  if constexpr (J == std::tuple_size_v<DenTuple>) {
+    const auto numerator = ProductOfFactors(num);
+    const auto denominator = ProductOfFactors(den);
+    if constexpr (is_one_v<std::decay_t<decltype(denominator)>>) {
+      return numerator;
+    } else {
+      return Quotient(numerator, denominator);
+    }
+  }
+  else {
+    typedef std::tuple_element_t<J, DenTuple> DenFactor;
+    constexpr std::size_t I = matching_factor<DenFactor, NumTuple>::value;
+    if constexpr (I == std::tuple_size_v<NumTuple>) {
+      return CancelFactors<J+1>(num, den);
+    }
+    else {
+      const auto& n = std::get<I>(num);
+      const auto& d = std::get<J>(den);
+      if constexpr (is_static_coefficient_v<DenFactor>) {
+        return CancelFactors<J>(TupleReplace<I>(num, n / d), TupleWithout<J>(den));
+      }
+      else {
+        const auto exponent = FactorExponent(n) - FactorExponent(d);
+        typedef std::decay_t<decltype(exponent)> ExponentType;
+        if constexpr (is_zero_v<ExponentType>) {
+          return CancelFactors<J>(TupleWithout<I>(num), TupleWithout<J>(den));
+        }
+        else if constexpr (is_negative_constant_v<ExponentType>) {
+          return CancelFactors<J+1>(TupleWithout<I>(num), TupleReplace<J>(den, FactorBase(d) ^ (-exponent)));
+        }
+        else {
+          return CancelFactors<J>(TupleReplace<I>(num, FactorBase(n) ^ exponent), TupleWithout<J>(den));
+        }
+      }
+    }
+  }
+}
+
+
+// Nested quotients are flattened so that a chain evaluates with one division,
+// and factors common to the numerator and denominator cancel: x^2 / x^3 -> 1 / x
+template<typename Sym1, typename Sym2>
+constexpr auto QuotientImpl(const SymbolicBase<Sym1>& expr1, const SymbolicBase<Sym2>& expr2)
 {
   static_assert(!is_zero_v<Sym2>, "Cannot divide by zero");
+  typedef decltype(FactorTuple(expr1)) NumTuple;
+  typedef decltype(FactorTuple(expr2)) DenTuple;
   if constexpr (is_zero_v<Sym1>) {
     return Zero<>();
   }
   else if constexpr (is_same_v<Sym1,Sym2>) {
     return One<>();
   }
+  else if constexpr (is_one_v<Sym2>) {
+    return expr1.derived();
+  }
+  else if constexpr (is_negation_v<Sym1>) {
+    return -(expr1.derived().Negate() / expr2.derived());
+  }
+  else if constexpr (is_negation_v<Sym2>) {
+    return -(expr1.derived() / expr2.derived().Negate());
+  }
+  else if constexpr (is_quotient_v<Sym1>) {
+    return expr1.derived().Numerator() / (expr1.derived().Denominator() * expr2.derived());
+  }
+  else if constexpr (is_quotient_v<Sym2>) {
+    return (expr1.derived() * expr2.derived().Denominator()) / expr2.derived().Numerator();
+  }
+  else if constexpr (shares_factor<NumTuple,DenTuple>::value) {
+    return CancelFactors<0>(FactorTuple(expr1), FactorTuple(expr2));
+  }
   else {
     return Quotient(expr1.derived(),expr2.derived());
   }
 }
 
+// Every quotient built goes through the construction rules, see ConstructionRules
+template<typename Sym1, typename Sym2>
+constexpr auto
+operator/(const SymbolicBase<Sym1>& expr1, const SymbolicBase<Sym2>& expr2)
+{
+  return ApplyConstructionRules(QuotientImpl(expr1, expr2));
+}
+
 } // Symbolic namespace
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,319 @@
+#ifndef SYMBOLIC_INCLUDE_REWRITE_HPP
+#define SYMBOLIC_INCLUDE_REWRITE_HPP
+
+#include <tuple>
+#include <string>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+#include "metaprogramming.hpp"
+#include "symbolic_base.hpp"
+#include "prototyping.hpp"
+#include "constants.hpp"
+#include "ordering.hpp"
+#include "structure.hpp"
+
+// How many times Simplify may rewrite the result of a rewrite
+#ifndef SYMBOLIC_REWRITE_DEPTH
+#define SYMBOLIC_REWRITE_DEPTH 8
+#endif
+
+// Rules applied while expressions are built, see ConstructionRules
+#ifndef SYMBOLIC_CONSTRUCTION_RULES
+#define SYMBOLIC_CONSTRUCTION_RULES RuleSet<>
+#endif
+
+
+namespace SYMBOLIC_NAMESPACE_NAME {
+
+// WILDCARD
+// Placeholder in the pattern of a Rule, matching any subexpression. Every
+// occurrence of Wildcard<I> in a pattern must match the same subexpression;
+// since runtime values can't be compared at compile time, a repeated wildcard
+// only matches static subtrees.
+template<std::size_t I>
+class Wildcard : public SymbolicBase< Wildcard<I> >
+{
+public:
+  static constexpr bool is_leaf = true;
+  static constexpr bool is_dynamic = false;
+
+  constexpr Wildcard() = default;
+
+  std::string str() const
+  {
+    return "_" + std::to_string(I);
+  }
+};
+
+template<typename SymType>
+struct is_wildcard
+{
+  static constexpr bool value = false;
+};
+
+template<std::size_t I>
+struct is_wildcard<Wildcard<I>>
+{
+  static constexpr bool value = true;
+  static constexpr std::size_t index = I;
+};
+
+template<typename SymType>
+constexpr bool is_wildcard_v = is_wildcard<SymType>::value;
+
+
+// Subexpression bound to Wildcard<I> by a match
+template<std::size_t I, typename SymType>
+struct Binding
+{
+  SymType expr;
+};
+
+struct NoMatch {};
+
+// Position of the binding of Wildcard<I> in a tuple of bindings, or its size
+template<std::size_t I, class BindTuple>
+struct bound_index;
+
+template<std::size_t I, std::size_t... J, class... Syms>
+struct bound_index<I, std::tuple<Binding<J,Syms>...>>
+{
+  static constexpr std::size_t find()
+  {
+    constexpr bool matches[] = { (I == J)..., false };
+    std::size_t index = 0;
+    while (index < sizeof...(J) && !matches[index]) {
+      ++index;
+    }
+    return index;
+  }
+
+  static constexpr std::size_t value = find();
+};
+
+// Same node class with the same number of children
+template<typename Sym1, typename Sym2>
+struct same_node_template
+{
+  static constexpr bool value = false;
+};
+
+template<template<typename...> class Node, class... Syms1, class... Syms2>
+struct same_node_template<Node<Syms1...>, Node<Syms2...>>
+{
+  static constexpr bool value = (sizeof...(Syms1) == sizeof...(Syms2));
+};
+
+
+// MATCH
+template<typename Pattern, typename SymType, class BindTuple>
+constexpr auto MatchNode(const SymType& expr, const BindTuple& bindings);
+
+template<std::size_t K, class... Patterns, class ChildTuple, class BindTuple>
+constexpr auto MatchChildren(type_list<Patterns...>, const ChildTuple& children, const BindTuple& bindings)
+{
+  if constexpr (K == sizeof...(Patterns)) {
+    return bindings;
+  } else {
+    const auto next = MatchNode<NthTypeOf<K,Patterns...>>(std::get<K>(children), bindings);
+    if constexpr (std::is_same_v<std::decay_t<decltype(next)>, NoMatch>) {
+      return NoMatch();
+    } else {
+      return MatchChildren<K+1>(type_list<Patterns...>(), children, next);
+    }
+  }
+}
+
+template<typename Pattern, typename SymType, class BindTuple>
+constexpr auto MatchNode(const SymType& expr, const BindTuple& bindings)
+{
+  if constexpr (is_wildcard_v<Pattern>) {
+    constexpr std::size_t I = is_wildcard<Pattern>::index;
+    constexpr std::size_t N = bound_index<I, BindTuple>::value;
+    if constexpr (N == std::tuple_size_v<BindTuple>) {
+      return std::tuple_cat(bindings, std::make_tuple(Binding<I,SymType>{expr}));
+    }
+    else if constexpr (std::is_same_v<decltype(std::get<N>(bindings).expr), SymType> && !SymType::is_dynamic) {
+      return bindings;
+    }
+    else {
+      return NoMatch();
+    }
+  }
+  else if constexpr (std::is_same_v<Pattern, SymType>) {
+    return bindings;
+  }
+  else if constexpr (same_node_template<Pattern, SymType>::value && node_children_t<SymType>::size > 0) {
+    return MatchChildren<0>(node_children_t<Pattern>(), Children(expr), bindings);
+  }
+  else {
+    return NoMatch();
+  }
+}
+
+// Bindings of the wildcards of Pattern when it matches expr, NoMatch otherwise.
+// Leaves of a pattern match by type. Sums and products match term by term in
+// their canonical order, and only when they have as many terms as the pattern.
+template<typename Pattern, typename SymType>
+constexpr auto Match(const SymbolicBase<SymType>& expr)
+{
+  return MatchNode<Pattern>(expr.derived(), std::tuple<>());
+}
+
+template<typename Pattern, typename SymType>
+constexpr bool matches_v =
+  !std::is_same_v<decltype(Match<Pattern>(std::declval<SymType>())), NoMatch>;
+
+
+// INSTANTIATE
+// Replacement with every wildcard substituted by its binding, rebuilt through
+// the operators so that the result is simplified
+template<typename Replacement, class BindTuple>
+constexpr auto Instantiate(const BindTuple& bindings)
+{
+  if constexpr (is_wildcard_v<Replacement>) {
+    constexpr std::size_t N = bound_index<is_wildcard<Replacement>::index, BindTuple>::value;
+    static_assert(N < std::tuple_size_v<BindTuple>, "Replacement uses a wildcard its pattern does not bind");
+    return std::get<N>(bindings).expr;
+  }
+  else if constexpr (node_children_t<Replacement>::size == 0) {
+    static_assert(!Replacement::is_dynamic, "Leaves of a replacement must be static");
+    return Replacement();
+  }
+  else {
+    return [&]<class... Syms>(type_list<Syms...>) {
+      return Reapply(Replacement(), Instantiate<Syms>(bindings)...);
+    }(node_children_t<Replacement>());
+  }
+}
+
+
+// RULES
+// Pattern -> Replacement, both written as node types with wildcards, e.g.
+//   Rule< Exponential<constant_e<>, Logarithm<constant_e<>, Wildcard<0>>>, Wildcard<0> >
+template<typename Pattern, typename Replacement>
+struct Rule
+{
+  template<typename SymType>
+  static constexpr bool matches = matches_v<Pattern, SymType>;
+
+  template<typename SymType>
+  static constexpr auto Apply(const SymbolicBase<SymType>& expr)
+  {
+    return Instantiate<Replacement>(Match<Pattern>(expr));
+  }
+};
+
+// Ordered set of rules: the first rule matching a node is the one applied
+template<class... Rules>
+struct RuleSet
+{
+  template<typename SymType>
+  static constexpr std::size_t first_match()
+  {
+    return FirstTrue<Rules::template matches<SymType>...>();
+  }
+
+  template<typename SymType>
+  static constexpr bool matches = (first_match<SymType>() < sizeof...(Rules));
+
+  template<typename SymType>
+  static constexpr auto Apply(const SymbolicBase<SymType>& expr)
+  {
+    return NthTypeOf<first_match<SymType>(), Rules...>::Apply(expr);
+  }
+};
+
+// Rules of both sets, those of Set1 first
+template<class Set1, class Set2>
+struct rule_set_cat;
+
+template<class... Rules1, class... Rules2>
+struct rule_set_cat<RuleSet<Rules1...>, RuleSet<Rules2...>>
+{
+  typedef RuleSet<Rules1..., Rules2...> type;
+};
+
+template<class Set1, class Set2>
+using rule_set_cat_t = typename rule_set_cat<Set1,Set2>::type;
+
+
+// Identities between exp and ln that hold wherever both sides are defined
+typedef RuleSet<
+    Rule< Exponential<constant_e<>, Logarithm<constant_e<>, Wildcard<0>>>, Wildcard<0> >,
+    Rule< Logarithm<constant_e<>, Exponential<constant_e<>, Wildcard<0>>>, Wildcard<0> >
+  > ExpLogRules;
+
+
+// SIMPLIFY
+template<class Rules, std::size_t Budget, typename SymType>
+constexpr auto SimplifyImpl(const SymbolicBase<SymType>& expr);
+
+template<class Rules, std::size_t Budget, typename SymType>
+constexpr auto RewriteRoot(const SymbolicBase<SymType>& expr)
+{
+  if constexpr (Budget > 0 && Rules::template matches<SymType>) {
+    return SimplifyImpl<Rules, Budget-1>(Rules::Apply(expr));
+  } else {
+    return expr.derived();
+  }
+}
+
+template<class Rules, std::size_t Budget, typename SymType>
+constexpr auto SimplifyImpl(const SymbolicBase<SymType>& expr)
+{
+  const auto node = std::apply(
+    [&](const auto&... children) { return Reapply(expr, SimplifyImpl<Rules,Budget>(children)...); },
+    Children(expr));
+  return RewriteRoot<Rules,Budget>(node);
+}
+
+// Applies Rules to every node bottom up, rewriting the result of a rewrite
+// again up to SYMBOLIC_REWRITE_DEPTH times
+template<class Rules, typename SymType>
+constexpr auto Simplify(const SymbolicBase<SymType>& expr)
+{
+  return SimplifyImpl<Rules, SYMBOLIC_REWRITE_DEPTH>(expr);
+}
+
+
+// CONSTRUCTION RULES
+// Rule set applied to every node built by +, -, *, /, ^, ln, exp, pow, sqrt,
+// the trigonometric functions and abs, including the nodes they build for one
+// another and for derivatives. Unary minus is not rewritten. Empty by default;
+// define SYMBOLIC_CONSTRUCTION_RULES before including the library to add rules:
+//   #define SYMBOLIC_CONSTRUCTION_RULES ExpLogRules
+// A set of your own can be declared first and defined after the include, since
+// it is only looked up when an expression is built:
+//   namespace Smel { struct MyRules; }
+//   #define SYMBOLIC_CONSTRUCTION_RULES MyRules
+//   #include "SMEL/Expressions"
+//   struct Smel::MyRules : RuleSet< Rule<Quotient<Sine<Wildcard<0>>, Cosine<Wildcard<0>>>, Tangent<Wildcard<0>>> > {};
+// Rules should make a tree smaller, since a rewrite is built through the same
+// functions and is rewritten again.
+typedef SYMBOLIC_CONSTRUCTION_RULES ConstructionRules;
+
+// ConstructionRules, named through the node type so that it may still be
+// incomplete where this header is read
+template<typename SymType>
+struct construction_rules
+{
+  typedef ConstructionRules type;
+};
+
+template<typename SymType>
+constexpr auto ApplyConstructionRules(const SymType& expr)
+{
+  typedef typename construction_rules<SymType>::type Rules;
+  if constexpr (Rules::template matches<SymType>) {
+    return RewriteRoot<Rules, SYMBOLIC_REWRITE_DEPTH>(expr);
+  } else {
+    return expr;
+  }
+}
+
+
+} // Symbolic namespace
+#endif
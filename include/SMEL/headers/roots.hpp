@@ -0,0 +1,178 @@
+#ifndef SYMBOLIC_INCLUDE_ROOTS_HPP
+#define SYMBOLIC_INCLUDE_ROOTS_HPP
+
+#include <span>
+#include <cmath>
+#include <limits>
+#include <cassert>
+#include <cstddef>
+#include <concepts>
+#include <algorithm>
+#include <type_traits>
+
+#include "symbolic_base.hpp"
+
+
+namespace SYMBOLIC_NAMESPACE_NAME {
+
+enum class RootMethod { Newton, Halley };
+
+// Number of problems iterated together; eight doubles fill two AVX registers
+// in the evaluation loops.
+inline constexpr std::size_t root_block_size = 8;
+
+
+template<RootMethod Method, std::size_t Lanes, typename SymType, typename D1Type, typename D2Type, typename FloatType>
+int SolveRootsBlock(
+  const SymType& expr,
+  const D1Type& d1,
+  const D2Type& d2,
+  const FloatType* targets,
+  const FloatType* guesses,
+  FloatType* out,
+  int* iterations,
+  const std::size_t count,
+  const FloatType tol,
+  const int max_iterations)
+{
+  FloatType x[Lanes], t[Lanes], lo[Lanes], hi[Lanes], last_residual[Lanes];
+  bool have_lo[Lanes], have_hi[Lanes], active[Lanes], converged[Lanes];
+  int iters[Lanes];
+
+  // Padding lanes repeat the last problem so every lane does valid work
+  for (std::size_t i = 0; i < Lanes; ++i) {
+    const std::size_t src = (i < count) ? i : (count - 1);
+    x[i] = guesses[src];
+    t[i] = targets[src];
+    lo[i] = hi[i] = x[i];
+    last_residual[i] = std::numeric_limits<FloatType>::infinity();
+    have_lo[i] = have_hi[i] = false;
+    active[i] = (i < count);
+    converged[i] = false;
+    iters[i] = 0;
+  }
+
+  for (int it = 0; it < max_iterations; ++it) {
+    bool any_active = false;
+    for (std::size_t i = 0; i < Lanes; ++i) {
+      any_active |= active[i];
+    }
+    if (!any_active) {
+      break;
+    }
+
+    // Every lane is evaluated first, padding and finished lanes included, so
+    // that these loops and the update below carry no data-dependent branches
+    FloatType g[Lanes], dg[Lanes], ddg[Lanes];
+    for (std::size_t i = 0; i < Lanes; ++i) {
+      g[i] = expr.Evaluate(x[i]) - t[i];
+    }
+    for (std::size_t i = 0; i < Lanes; ++i) {
+      dg[i] = d1.Evaluate(x[i]);
+    }
+    if constexpr (Method == RootMethod::Halley) {
+      for (std::size_t i = 0; i < Lanes; ++i) {
+        ddg[i] = d2.Evaluate(x[i]);
+      }
+    }
+
+    // Masked update: conditions select values instead of branching, combined
+    // with | and & rather than short-circuiting
+    for (std::size_t i = 0; i < Lanes; ++i) {
+      FloatType step;
+      if constexpr (Method == RootMethod::Halley) {
+        step = (static_cast<FloatType>(2) * g[i] * dg[i])
+            / (static_cast<FloatType>(2) * dg[i] * dg[i] - g[i] * ddg[i]);
+      } else {
+        step = g[i] / dg[i];
+      }
+
+      const FloatType abs_g = std::abs(g[i]);
+      const bool done = (abs_g <= tol)
+          | (std::abs(step) <= tol * std::max(static_cast<FloatType>(1), std::abs(x[i])));
+
+      // Keep track of any sign change seen so far to fall back on bisection
+      const bool below = g[i] < static_cast<FloatType>(0);
+      lo[i] = below ? x[i] : lo[i];
+      hi[i] = below ? hi[i] : x[i];
+      have_lo[i] = have_lo[i] | below;
+      have_hi[i] = have_hi[i] | !below;
+      const bool bracketed = have_lo[i] & have_hi[i];
+
+      const FloatType newton = x[i] - step;
+      const bool diverged = !std::isfinite(newton) | (abs_g > last_residual[i]);
+      const bool escaped = bracketed
+          & ((newton < std::min(lo[i], hi[i])) | (newton > std::max(lo[i], hi[i])));
+      const FloatType fallback = bracketed ? (lo[i] + hi[i]) / static_cast<FloatType>(2)
+                                           : x[i] - step / static_cast<FloatType>(2);
+      const FloatType next = (diverged | escaped) ? fallback : newton;
+      const bool failed = !std::isfinite(next) & !done;
+
+      // A converged lane still takes its last step unless the residual is
+      // already within tol
+      const FloatType updated = done ? ((abs_g > tol) ? newton : x[i])
+                                     : (failed ? x[i] : next);
+      const bool live = active[i];
+      iters[i] += live;
+      converged[i] = live ? done : converged[i];
+      x[i] = live ? updated : x[i];
+      last_residual[i] = live ? std::min(last_residual[i], abs_g) : last_residual[i];
+      active[i] = live & !done & !failed;
+    }
+  }
+
+  int n_converged = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = x[i];
+    if (iterations != nullptr) {
+      iterations[i] = converged[i] ? iters[i] : -1;
+    }
+    n_converged += converged[i];
+  }
+  return n_converged;
+}
+
+
+// Solves expr(x) = targets[i] for every i starting from guesses[i], writing the
+// roots to out. All problems are iterated in lockstep blocks of root_block_size,
+// the derivative expressions are built once per call. If given, iterations[i]
+// receives the number of steps taken, or -1 if problem i did not converge.
+// Returns the number of problems that converged.
+template<RootMethod Method = RootMethod::Newton, typename SymType, std::floating_point FloatType>
+std::size_t SolveRoots(
+  const SymbolicBase<SymType>& expr,
+  const std::type_identity_t<std::span<const FloatType>> targets,
+  const std::type_identity_t<std::span<const FloatType>> guesses,
+  const std::type_identity_t<std::span<FloatType>> out,
+  const FloatType tol,
+  const std::span<int> iterations = {},
+  const int max_iterations = 64)
+{
+  assert(targets.size() == guesses.size());
+  assert(out.size() >= targets.size());
+  assert(iterations.empty() || (iterations.size() >= targets.size()));
+
+  const auto d1 = expr.derived().Derivative();
+  const auto d2 = [&]() {
+    if constexpr (Method == RootMethod::Halley) {
+      return d1.Derivative();
+    } else {
+      return Zero<>();
+    }
+  }();
+
+  std::size_t n_converged = 0;
+  for (std::size_t i = 0; i < targets.size(); i += root_block_size) {
+    const std::size_t count = std::min(root_block_size, targets.size() - i);
+    n_converged += SolveRootsBlock<Method, root_block_size>(
+      expr.derived(), d1, d2,
+      targets.data() + i, guesses.data() + i, out.data() + i,
+      iterations.empty() ? nullptr : iterations.data() + i,
+      count, tol, max_iterations);
+  }
+  return n_converged;
+}
+
+
+} // Symbolic namespace
+#endif
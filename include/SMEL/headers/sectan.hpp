@@ -25,29 +25,37 @@ template<typename SymType>
 class Tangent : public SymbolicBase< Tangent<SymType> >
 {
 private:
-  typename std::conditional_t<SymType::is_leaf, const SymType&, const SymType> expr_;
+  [[no_unique_address]] Branch<SymType> expr_;
 
 public:
   static constexpr bool is_leaf = false;
   static constexpr bool is_dynamic = SymType::is_dynamic;
 
+  constexpr Tangent() = default;
+
   constexpr Tangent(const SymType& expr) : expr_{expr}
   {}
 
   template<typename FloatType>
   FloatType Evaluate(const FloatType input) const
   {
-    return std::tan(expr_.Evaluate(input));
+    using std::tan;
+    return tan(expr_->Evaluate(input));
   }
 
   constexpr auto Derivative() const
   {
-    return pow<2>( Secant<SymType>(expr_) ) * expr_.Derivative();
+    return pow<2>( Secant<SymType>(*expr_) ) * expr_->Derivative();
   }
 
   std::string str() const
   {
-    return "tan(" + expr_.str() + ")";
+    return "tan(" + expr_->str() + ")";
+  }
+
+  constexpr auto Argument() const
+  {
+    return *expr_;
   }
 };
 
@@ -56,29 +64,37 @@ template<typename SymType>
 class Secant : public SymbolicBase< Secant<SymType> >
 {
 private:
-  typename std::conditional_t<SymType::is_leaf, const SymType&, const SymType> expr_;
+  [[no_unique_address]] Branch<SymType> expr_;
 
 public:
   static constexpr bool is_leaf = false;
   static constexpr bool is_dynamic = SymType::is_dynamic;
 
+  constexpr Secant() = default;
+
   constexpr Secant(const SymType& expr) : expr_{expr}
   {}
 
   template<typename FloatType>
   FloatType Evaluate(const FloatType input) const
   {
-    return (1.0 / std::cos(expr_.Evaluate(input)));
+    using std::cos;
+    return (static_cast<FloatType>(1) / cos(expr_->Evaluate(input)));
   }
 
   constexpr auto Derivative() const
   {
-    return Secant<SymType>(expr_) * Tangent<SymType>(expr_) * expr_.Derivative();
+    return Secant<SymType>(*expr_) * Tangent<SymType>(*expr_) * expr_->Derivative();
   }
 
   std::string str() const
   {
-    return "sec(" + expr_.str() + ")";
+    return "sec(" + expr_->str() + ")";
+  }
+
+  constexpr auto Argument() const
+  {
+    return *expr_;
   }
 };
 
@@ -88,29 +104,37 @@ template<typename SymType>
 class ArcTangent : public SymbolicBase< ArcTangent<SymType> >
 {
 private:
-  typename std::conditional_t<SymType::is_leaf, const SymType&, const SymType> expr_;
+  [[no_unique_address]] Branch<SymType> expr_;
 
 public:
   static constexpr bool is_leaf = false;
   static constexpr bool is_dynamic = SymType::is_dynamic;
 
+  constexpr ArcTangent() = default;
+
   constexpr ArcTangent(const SymType& expr) : expr_{expr}
   {}
 
   template<typename FloatType>
   FloatType Evaluate(const FloatType input) const
   {
-    return std::atan(expr_.Evaluate(input));
+    using std::atan;
+    return atan(expr_->Evaluate(input));
   }
 
   constexpr auto Derivative() const
   {
-    return expr_.Derivative() / ( One<>() + pow<2>(expr_) );
+    return expr_->Derivative() / ( One<>() + pow<2>(*expr_) );
   }
 
   std::string str() const
   {
-    return "arctan(" + expr_.str() + ")";
+    return "arctan(" + expr_->str() + ")";
+  }
+
+  constexpr auto Argument() const
+  {
+    return *expr_;
   }
 };
 
@@ -119,12 +143,14 @@ template<typename SymType>
 class ArcSecant : public SymbolicBase< ArcSecant<SymType> >
 {
 private:
-  typename std::conditional_t<SymType::is_leaf, const SymType&, const SymType> expr_;
+  [[no_unique_address]] Branch<SymType> expr_;
 
 public:
   static constexpr bool is_leaf = false;
   static constexpr bool is_dynamic = SymType::is_dynamic;
 
+  constexpr ArcSecant() = default;
+
   constexpr ArcSecant(const SymType& expr) : expr_{expr}
   {}
 
@@ -132,43 +158,49 @@ public:
   FloatType Evaluate(const FloatType input) const
   {
     //TODO verify
-    return std::acos(1.0 / expr_.Evaluate(input));
+    using std::acos;
+    return acos(static_cast<FloatType>(1) / expr_->Evaluate(input));
   }
 
   constexpr auto Derivative() const
   {
-    return expr_.Derivative() / ( abs(expr_) * sqrt((expr_ ^ Int<2>()) - One<>()) );
+    return expr_->Derivative() / ( abs(*expr_) * sqrt((*expr_ ^ Int<2>()) - One<>()) );
   }
 
   std::string str() const
   {
-    return "arcsec(" + expr_.str() + ")";
+    return "arcsec(" + expr_->str() + ")";
+  }
+
+  constexpr auto Argument() const
+  {
+    return *expr_;
   }
 };
 
 
 template<typename SymType>
-auto tan(const SymbolicBase<SymType> expr)
+auto tan(const SymbolicBase<SymType>& expr)
 {
-  return Tangent<SymType>(expr.derived());
+  return ApplyConstructionRules(Tangent<SymType>(expr.derived()));
 }
 
 template<typename SymType>
-auto sec(const SymbolicBase<SymType> expr)
+auto sec(const SymbolicBase<SymType>& expr)
 {
-  return Secant<SymType>(expr.derived());
+  return ApplyConstructionRules(Secant<SymType>(expr.derived()));
 }
 
 template<typename SymType>
-auto arctan(const SymbolicBase<SymType> expr)
+auto arctan(const SymbolicBase<SymType>& expr)
 {
-  return ArcTangent<SymType>(expr.derived());
+  return ApplyConstructionRules(ArcTangent<SymType>(expr.derived()));
 }
 
 template<typename SymType>
-auto arcsec(const SymbolicBase<SymType> expr)
+auto arcsec(const SymbolicBase<SymType>& expr)
 {
-  return ArcSecant<SymType>(expr.derived());
+  return ApplyConstructionRules(ArcSecant<SymType>(expr.derived()));
 }
 
 
@@ -25,29 +25,37 @@ template<typename SymType>
 class Sine : public SymbolicBase< Sine<SymType> >
 {
 private:
-  typename std::conditional_t<SymType::is_leaf, const SymType&, const SymType> expr_;
+  [[no_unique_address]] Branch<SymType> expr_;
 
 public:
   static constexpr bool is_leaf = false;
   static constexpr bool is_dynamic = SymType::is_dynamic;
 
+  constexpr Sine() = default;
+
   constexpr Sine(const SymType& expr) : expr_{expr}
   {}
 
   template<typename FloatType>
   constexpr FloatType Evaluate(const FloatType input) const
   {
-    return std::sin(expr_.Evaluate(input));
+    using std::sin;
+    return sin(expr_->Evaluate(input));
   }
 
   constexpr auto Derivative() const
   {
-    return Cosine<SymType>(expr_) * expr_.Derivative();
+    return Cosine<SymType>(*expr_) * expr_->Derivative();
   }
 
   std::string str() const
   {
-    return "sin(" + expr_.str() + ")";
+    return "sin(" + expr_->str() + ")";
+  }
+
+  constexpr auto Argument() const
+  {
+    return *expr_;
   }
 };
 
@@ -56,29 +64,37 @@ template<typename SymType>
 class Cosine : public SymbolicBase< Cosine<SymType> >
 {
 private:
-  typename std::conditional_t<SymType::is_leaf, const SymType&, const SymType> expr_;
+  [[no_unique_address]] Branch<SymType> expr_;
 
 public:
   static constexpr bool is_leaf = false;
   static constexpr bool is_dynamic = SymType::is_dynamic;
 
+  constexpr Cosine() = default;
+
   constexpr Cosine(const SymType& expr) : expr_{expr}
   {}
 
   template<typename FloatType>
   constexpr FloatType Evaluate(const FloatType input) const
   {
-    return std::cos(expr_.Evaluate(input));
+    using std::cos;
+    return cos(expr_->Evaluate(input));
   }
 
   constexpr auto Derivative() const
   {
-    return Sine<SymType>(expr_) * (-expr_.Derivative());
+    return Sine<SymType>(*expr_) * (-expr_->Derivative());
   }
 
   std::string str() const
   {
-    return "cos(" + expr_.str() + ")";
+    return "cos(" + expr_->str() + ")";
+  }
+
+  constexpr auto Argument() const
+  {
+    return *expr_;
   }
 };
 
@@ -87,12 +103,14 @@ template<typename SymType>
 class ArcSine : public SymbolicBase< ArcSine<SymType> >
 {
 private:
-  typename std::conditional_t<SymType::is_leaf, const SymType&, const SymType> expr_;
+  [[no_unique_address]] Branch<SymType> expr_;
 
 public:
   static constexpr bool is_leaf = false;
   static constexpr bool is_dynamic = SymType::is_dynamic;
 
+  constexpr ArcSine() = default;
+
   constexpr ArcSine(const SymType& expr) : expr_{expr}
   {}
 
@@ -100,17 +118,23 @@ public:
   FloatType Evaluate(const FloatType input) const
   {
     //TODO wrap input to be between [-1,1]?
-    return std::asin(expr_.Evaluate(input));
+    using std::asin;
+    return asin(expr_->Evaluate(input));
   }
 
   constexpr auto Derivative() const
   {
-    return pow<-0.5>( One<>() - pow<2>(expr_) ) * expr_.Derivative();
+    return pow<-0.5>( One<>() - pow<2>(*expr_) ) * expr_->Derivative();
   }
 
   std::string str() const
   {
-    return "arcsin(" + expr_.str() + ")";
+    return "arcsin(" + expr_->str() + ")";
+  }
+
+  constexpr auto Argument() const
+  {
+    return *expr_;
   }
 };
 
@@ -119,12 +143,14 @@ template<typename SymType>
 class ArcCosine : public SymbolicBase< ArcCosine<SymType> >
 {
 private:
-  typename std::conditional_t<SymType::is_leaf, const SymType&, const SymType> expr_;
+  [[no_unique_address]] Branch<SymType> expr_;
 
 public:
   static constexpr bool is_leaf = false;
   static constexpr bool is_dynamic = SymType::is_dynamic;
 
+  constexpr ArcCosine() = default;
+
   constexpr ArcCosine(const SymType& expr) : expr_{expr}
   {}
 
@@ -132,17 +158,23 @@ public:
   FloatType Evaluate(const FloatType input) const
   {
     //TODO wrap input to be between [-1,1]?
-    return std::acos(expr_.Evaluate(input));
+    using std::acos;
+    return acos(expr_->Evaluate(input));
   }
 
   constexpr auto Derivative() const
   {
-    return pow<-0.5>( One<>() - pow<2>(expr_) ) * (-expr_.Derivative());
+    return pow<-0.5>( One<>() - pow<2>(*expr_) ) * (-expr_->Derivative());
   }
 
   std::string str() const
   {
-    return "arccos(" + expr_.str() + ")";
+    return "arccos(" + expr_->str() + ")";
+  }
+
+  constexpr auto Argument() const
+  {
+    return *expr_;
   }
 };
 
@@ -150,25 +182,25 @@ public:
 template<typename SymType>
 constexpr auto sin(const SymbolicBase<SymType>& expr)
 {
-  return Sine<SymType>(expr.derived());
+  return ApplyConstructionRules(Sine<SymType>(expr.derived()));
 }
 
 template<typename SymType>
 constexpr auto cos(const SymbolicBase<SymType>& expr)
 {
-  return Cosine<SymType>(expr.derived());
+  return ApplyConstructionRules(Cosine<SymType>(expr.derived()));
 }
 
 template<typename SymType>
 constexpr auto arcsin(const SymbolicBase<SymType>& expr)
 {
-  return ArcSine<SymType>(expr.derived());
+  return ApplyConstructionRules(ArcSine<SymType>(expr.derived()));
 }
 
 template<typename SymType>
 constexpr auto arccos(const SymbolicBase<SymType>& expr)
 {
-  return ArcCosine<SymType>(expr.derived());
+  return ApplyConstructionRules(ArcCosine<SymType>(expr.derived()));
 }
 
 
@@ -0,0 +1,68 @@
+#ifndef SYMBOLIC_INCLUDE_SPECIALIZE_HPP
+#define SYMBOLIC_INCLUDE_SPECIALIZE_HPP
+
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
+#include "symbolic_base.hpp"
+#include "prototyping.hpp"
+#include "constants.hpp"
+#include "structure.hpp"
+#include "intern.hpp"
+#include "bind.hpp"
+
+
+namespace SYMBOLIC_NAMESPACE_NAME {
+
+// Snapshot of expr with the current value of every Reference frozen into a
+// RuntimeConstant. Every subtree that doesn't depend on the input, and the
+// terms of a sum or product that don't, is evaluated into a single
+// RuntimeConstant, and the tree is rebuilt through the operators so that
+// runtime coefficients and like terms fold together. Values of type T are
+// only known at runtime, so a parameter equal to 0 or 1 is kept as a number
+// rather than removed. Later changes to the referenced values don't affect
+// the result.
+template<typename T = double, typename SymType>
+constexpr auto Specialize(const SymbolicBase<SymType>& expr)
+{
+  if constexpr (!SymType::is_dynamic) {
+    return expr.derived();
+  }
+  else if constexpr (!depends_on_input_v<SymType>) {
+    return RuntimeConstant<T>(expr.Evaluate(static_cast<T>(0)));
+  }
+  else if constexpr (is_interned_v<SymType>) {
+    return Specialize<T>(expr.derived().Node());
+  }
+  else if constexpr (is_bound_v<SymType>) {
+    return Specialize<T>(expr.derived().Expression());
+  }
+  else if constexpr (input_split<SymType>::value) {
+    const auto children = Children(expr);
+    const T zero = static_cast<T>(0);
+    const auto independent = [&]<std::size_t... I>(std::index_sequence<I...>) {
+      if constexpr (is_sum_v<SymType>) {
+        return RuntimeConstant<T>((zero + ... + std::get<I>(children).Evaluate(zero)));
+      } else {
+        return RuntimeConstant<T>((static_cast<T>(1) * ... * std::get<I>(children).Evaluate(zero)));
+      }
+    }(typename input_split<SymType>::Independent());
+    return [&]<std::size_t... D>(std::index_sequence<D...>) {
+      if constexpr (is_sum_v<SymType>) {
+        return (independent + ... + Specialize<T>(std::get<D>(children)));
+      } else {
+        return (independent * ... * Specialize<T>(std::get<D>(children)));
+      }
+    }(typename input_split<SymType>::Dependent());
+  }
+  else {
+    return std::apply(
+      [&](const auto&... children) { return Reapply(expr, Specialize<T>(children)...); },
+      Children(expr));
+  }
+}
+
+
+} // Symbolic namespace
+#endif
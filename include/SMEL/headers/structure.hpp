@@ -0,0 +1,131 @@
+#ifndef SYMBOLIC_INCLUDE_STRUCTURE_HPP
+#define SYMBOLIC_INCLUDE_STRUCTURE_HPP
+
+#include <tuple>
+#include <utility>
+
+#include "prototyping.hpp"
+#include "type_deductions.hpp"
+#include "ordering.hpp"
+
+
+namespace SYMBOLIC_NAMESPACE_NAME {
+
+template<typename SymType>
+struct is_product_derivative
+{
+  static constexpr bool value = false;
+};
+
+template<typename... Syms>
+struct is_product_derivative<ProductDerivative<Syms...>>
+{
+  static constexpr bool value = true;
+};
+
+template<typename SymType>
+constexpr bool is_product_derivative_v = is_product_derivative<SymType>::value;
+
+
+template<class SymType, std::size_t... I>
+constexpr auto ElementsOf(const SymType& expr, const std::index_sequence<I...>)
+{
+  return std::make_tuple(get<I>(expr)...);
+}
+
+// CHILDREN
+// Child expressions of a node as a tuple, in the order of its template
+// arguments. Leaves have no children.
+template<typename SymType>
+constexpr auto Children(const SymbolicBase<SymType>& expr)
+{
+  const SymType& node = expr.derived();
+  if constexpr (node_children_t<SymType>::size == 0) {
+    return std::tuple<>();
+  }
+  else if constexpr (is_sum_v<SymType> || is_product_v<SymType>) {
+    return ElementsOf(node, std::make_index_sequence<SymType::size>());
+  }
+  else if constexpr (is_product_derivative_v<SymType>) {
+    return node.Factors();
+  }
+  else if constexpr (node_kind_v<SymType> == NodeKind::Quotient || node_kind_v<SymType> == NodeKind::IntegerFraction) {
+    return std::make_tuple(node.Numerator(), node.Denominator());
+  }
+  else if constexpr (node_kind_v<SymType> == NodeKind::Exponential) {
+    return std::make_tuple(node.Base(), node.Exponent());
+  }
+  else if constexpr (node_kind_v<SymType> == NodeKind::Logarithm) {
+    return std::make_tuple(node.Base(), node.Argument());
+  }
+  else {
+    return std::make_tuple(node.Argument());
+  }
+}
+
+
+// REBUILD
+// Same kind of node as expr over new children, bypassing the simplifications
+// the operators would apply
+template<template<typename...> class Node, class... Syms, class... ChildTypes>
+constexpr auto RebuildImpl(const Node<Syms...>&, const ChildTypes&... children)
+{
+  return Node<ChildTypes...>(children...);
+}
+
+template<typename SymType, class... ChildTypes>
+constexpr auto Rebuild(const SymbolicBase<SymType>& expr, const ChildTypes&... children)
+{
+  static_assert(sizeof...(ChildTypes) == node_children_t<SymType>::size, "Rebuild called with the wrong number of children");
+  if constexpr (sizeof...(ChildTypes) == 0) {
+    return expr.derived();
+  } else {
+    return RebuildImpl(expr.derived(), children...);
+  }
+}
+
+
+// REAPPLY
+// Same operation as expr applied to new children through the operators, so the
+// result is simplified again (like terms collected, powers merged, ...)
+template<typename SymType, class... ChildTypes>
+constexpr auto Reapply(const SymbolicBase<SymType>& expr, const ChildTypes&... children)
+{
+  static_assert(sizeof...(ChildTypes) == node_children_t<SymType>::size, "Reapply called with the wrong number of children");
+  if constexpr (is_sum_v<SymType>) {
+    return (children + ...);
+  }
+  else if constexpr (is_product_v<SymType>) {
+    return (children * ...);
+  }
+  else if constexpr (node_kind_v<SymType> == NodeKind::Quotient) {
+    return [](const auto& num, const auto& den) { return num / den; }(children...);
+  }
+  else if constexpr (node_kind_v<SymType> == NodeKind::Exponential) {
+    return [](const auto& base, const auto& exponent) { return base ^ exponent; }(children...);
+  }
+  else if constexpr (is_negation_v<SymType>) {
+    return [](const auto& arg) { return -arg; }(children...);
+  }
+  else {
+    return Rebuild(expr, children...);
+  }
+}
+
+
+// TRANSFORM
+// Applies function to every node bottom up: children are transformed first, the
+// node is rebuilt over the results and then passed to function
+template<typename SymType, typename Function>
+constexpr auto Transform(const SymbolicBase<SymType>& expr, const Function& function)
+{
+  return function(std::apply(
+    [&](const auto&... children) {
+      return Rebuild(expr, Transform(children, function)...);
+    },
+    Children(expr)));
+}
+
+
+} // Symbolic namespace
+#endif
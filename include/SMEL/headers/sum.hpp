@@ -5,8 +5,10 @@
 #include <utility>
 
 #include "symbolic_base.hpp"
+#include "prototyping.hpp"
 #include "constants.hpp"
 #include "concepts.hpp"
+#include "ordering.hpp"
 
 
 namespace SYMBOLIC_NAMESPACE_NAME {
@@ -20,7 +22,7 @@ constexpr auto MakeTupleSum(const TupleType& expr_tuple, const std::index_sequen
   if constexpr (sizeof...(I) == 1) {
     return std::get<I...>(expr_tuple);
   } else {
-    return TupleSum(std::get<I>(expr_tuple)...);
+    return MakeCanonical<TupleSum>(std::get<I>(expr_tuple)...);
   }
 }
 
@@ -35,16 +37,16 @@ template<class... ExprTypes>
 class TupleSum : public SymbolicBase< TupleSum<ExprTypes...> >
 {
 private:
-  std::tuple<typename BranchType<ExprTypes>::type...> exprs_;
+  [[no_unique_address]] std::tuple<Branch<ExprTypes>...> exprs_;
 
   template<std::size_t N, typename FloatType>
   constexpr FloatType RecursiveEvaluate(const FloatType& input) const
   {
     if constexpr (N == 0) {
-      return std::get<0>(exprs_).Evaluate(input);
+      return std::get<0>(exprs_)->Evaluate(input);
     }
     else {
-      return std::get<N>(exprs_).Evaluate(input) + RecursiveEvaluate<N-1>(input);
+      return std::get<N>(exprs_)->Evaluate(input) + RecursiveEvaluate<N-1>(input);
     }
   }
 
@@ -52,10 +54,10 @@ private:
   constexpr auto RecursiveDerivative() const
   {
     if constexpr (N == 0) {
-      return std::get<0>(exprs_).Derivative();
+      return std::get<0>(exprs_)->Derivative();
     }
     else {
-      return RecursiveDerivative<N-1>() + std::get<N>(exprs_).Derivative();
+      return RecursiveDerivative<N-1>() + std::get<N>(exprs_)->Derivative();
     }
   }
 
@@ -63,16 +65,19 @@ private:
   std::string sub_str() const
   {
     if constexpr (N == 0) {
-      return std::get<0>(exprs_).str();
+      return std::get<0>(exprs_)->str();
     }
     else {
-      return sub_str<N-1>() + " + " + std::get<N>(exprs_).str();
+      return sub_str<N-1>() + " + " + std::get<N>(exprs_)->str();
     }
   }
 
 public:
   static constexpr bool is_leaf = false;
   static constexpr bool is_dynamic = (ExprTypes::is_dynamic || ...);
+  static constexpr std::size_t size = sizeof...(ExprTypes);
+
+  constexpr TupleSum() = default;
 
   constexpr TupleSum(const ExprTypes&... exprs) : exprs_{exprs...}
   {
@@ -104,6 +109,12 @@ public:
     return "(" + sub_str<(sizeof...(ExprTypes))-1>() + ")";
   }
 
+  // Copies of the children, in order
+  constexpr std::tuple<ExprTypes...> Elements() const
+  {
+    return std::apply([](const auto&... exprs) { return std::tuple<ExprTypes...>(*exprs...); }, exprs_);
+  }
+
   template<std::size_t N, class... Exprs>
   friend constexpr auto get(const TupleSum<Exprs...>& sum);
 
@@ -111,23 +122,27 @@ public:
   constexpr auto ModifyElement(const SymbolicBase<SymType>& expr) const
   {
     static_assert(N < sizeof...(ExprTypes), "TupleSum::ModifyElement called with invalid index");
-    if constexpr (N == (sizeof...(ExprTypes)-1)) {
+    // Cancelled elements are dropped rather than kept as an explicit zero
+    if constexpr (is_zero<std::decay_t<decltype(*std::get<N>(exprs_) + expr.derived())>>::value) {
+      return Without<N>();
+    }
+    else if constexpr (N == (sizeof...(ExprTypes)-1)) {
       return MakeTupleSum(std::tuple_cat(
-        tuple_slice<0,N>(exprs_),
-        std::make_tuple(std::get<N>(exprs_) + expr.derived())
+        tuple_slice<0,N>(Elements()),
+        std::make_tuple(*std::get<N>(exprs_) + expr.derived())
       ));
     }
     else if constexpr (N == 0) {
       return MakeTupleSum(std::tuple_cat(
-        std::make_tuple(std::get<N>(exprs_) + expr.derived()),
-        tuple_slice<N+1, sizeof...(ExprTypes)>(exprs_)
+        std::make_tuple(*std::get<N>(exprs_) + expr.derived()),
+        tuple_slice<N+1, sizeof...(ExprTypes)>(Elements())
       ));
     }
     else {
       return MakeTupleSum(std::tuple_cat(
-        tuple_slice<0,N>(exprs_),
-        std::make_tuple(std::get<N>(exprs_) + expr.derived()),
-        tuple_slice<N+1, sizeof...(ExprTypes)>(exprs_)
+        tuple_slice<0,N>(Elements()),
+        std::make_tuple(*std::get<N>(exprs_) + expr.derived()),
+        tuple_slice<N+1, sizeof...(ExprTypes)>(Elements())
       ));
     }
   }
@@ -150,13 +165,13 @@ public:
       ((Is < sizeof...(ExprTypes)) && ...),
       "TupleSum::Without<Is...> has at least one index out of range");
     
-    return MakeTupleSum(exprs_, index_sequence_without<sizeof...(ExprTypes), Is...>());
+    return MakeTupleSum(Elements(), index_sequence_without<sizeof...(ExprTypes), Is...>());
   }
 
   template<std::size_t... Is>
   constexpr auto Subset() const
   {
-    return MakeTupleSum(exprs_, std::index_sequence<Is...>());
+    return MakeTupleSum(Elements(), std::index_sequence<Is...>());
   }
 
 };
@@ -165,32 +180,32 @@ public:
 template<std::size_t N, class... Exprs>
 constexpr auto get(const TupleSum<Exprs...>& sum)
 {
-  return std::get<N>(sum.exprs_);
+  return *std::get<N>(sum.exprs_);
 }
 
 template<class TupleType, class SymType, std::size_t... I>
 constexpr auto ExtendTupleSumImpl(const TupleType& expr_tuple, const SymbolicBase<SymType>& factor, const std::index_sequence<I...>)
 {
-  return TupleSum(std::get<I>(expr_tuple)..., factor.derived());
+  return MakeCanonical<TupleSum>(std::get<I>(expr_tuple)..., factor.derived());
 }
 
 template<class SymType, class... Factors>
 constexpr auto ExtendTupleSum(const TupleSum<Factors...>& sum, const SymbolicBase<SymType>& factor)
 {
-  return ExtendTupleSumImpl(sum.exprs_, factor.derived(), std::make_index_sequence<sizeof...(Factors)>());
+  return ExtendTupleSumImpl(sum.Elements(), factor.derived(), std::make_index_sequence<sizeof...(Factors)>());
 }
 
 
 template<class TupleType, class SymType, std::size_t... I>
 constexpr auto ExtendTupleSumImpl(const SymbolicBase<SymType>& factor, const TupleType& expr_tuple, const std::index_sequence<I...>)
 {
-  return TupleSum(factor.derived(), std::get<I>(expr_tuple)...);
+  return MakeCanonical<TupleSum>(factor.derived(), std::get<I>(expr_tuple)...);
 }
 
 template<class SymType, class... Factors>
 constexpr auto ExtendTupleSum(const SymbolicBase<SymType>& factor, const TupleSum<Factors...>& sum)
 {
-  return ExtendTupleSumImpl(factor.derived(), sum.exprs_, std::make_index_sequence<sizeof...(Factors)>());
+  return ExtendTupleSumImpl(factor.derived(), sum.Elements(), std::make_index_sequence<sizeof...(Factors)>());
 }
 
 
@@ -201,13 +216,13 @@ constexpr auto ExtendTupleSumImpl(
     const std::index_sequence<I1...>,
     const std::index_sequence<I2...>)
 {
-  return TupleSum(std::get<I1>(expr_tuple1)..., std::get<I2>(expr_tuple2)...);
+  return MakeCanonical<TupleSum>(std::get<I1>(expr_tuple1)..., std::get<I2>(expr_tuple2)...);
 }
 
 template<class... Sym1, class... Sym2>
 constexpr auto ExtendTupleSum(const TupleSum<Sym1...>& sum1, const TupleSum<Sym2...>& sum2)
 {
-  return ExtendTupleSumImpl(sum1.exprs_, sum2.exprs_,
+  return ExtendTupleSumImpl(sum1.Elements(), sum2.Elements(),
     std::make_index_sequence<sizeof...(Sym1)>(),
     std::make_index_sequence<sizeof...(Sym2)>());
 }
@@ -4,6 +4,7 @@
 #include "type_deductions.hpp"
 #include "symbolic_base.hpp"
 #include "constants.hpp"
+#include "hash.hpp"
 #include "concepts.hpp"
 #include "negation.hpp"
 #include "sum.hpp"
@@ -13,6 +14,143 @@
 
 namespace SYMBOLIC_NAMESPACE_NAME {
 
+// ------------------- Like terms -------------------
+// Views an expression as (coefficient * term). Products leading with a numeric
+// coefficient split it off, negations negate the coefficient and anything else
+// has a coefficient of one.
+template<typename SymType>
+struct coefficient_split
+{
+  static constexpr bool is_scaled = false;
+  typedef SymType term_type;
+};
+
+template<typename Sym1, typename... Syms>
+struct coefficient_split<TupleProduct<Sym1,Syms...>>
+{
+  static constexpr bool is_scaled = is_numeric_coefficient_v<Sym1>;
+  typedef std::conditional_t<is_scaled,
+      decltype(std::declval<TupleProduct<Sym1,Syms...>>().template Without<0>()),
+      TupleProduct<Sym1,Syms...>
+    > term_type;
+};
+
+template<typename SymType>
+struct coefficient_split<Negation<SymType>>
+{
+  static constexpr bool is_scaled = true;
+  typedef typename coefficient_split<SymType>::term_type term_type;
+};
+
+template<typename SymType>
+using term_type_t = typename coefficient_split<SymType>::term_type;
+
+// Structural hash of term_type_t<SymType>, without building the term
+template<typename SymType>
+struct term_hash
+{
+  static constexpr std::uint64_t value = structural_hash_v<SymType>;
+};
+
+template<typename Sym1, typename... Syms>
+struct term_hash<TupleProduct<Sym1,Syms...>>
+{
+  static constexpr std::uint64_t compute()
+  {
+    if constexpr (!is_numeric_coefficient_v<Sym1>) {
+      return structural_hash_v<TupleProduct<Sym1,Syms...>>;
+    } else if constexpr (sizeof...(Syms) == 1) {
+      return structural_hash_v<Syms...>;
+    } else {
+      return ChildrenHash<true>(KindHash(NodeKind::Product), type_list<Syms...>());
+    }
+  }
+
+  static constexpr std::uint64_t value = compute();
+};
+
+template<typename SymType>
+struct term_hash<Negation<SymType>>
+{
+  static constexpr std::uint64_t value = term_hash<SymType>::value;
+};
+
+// Two non-constant expressions that only differ by their numeric coefficient.
+// Terms are only built and compared when their hashes match.
+template<typename Sym1, typename Sym2>
+struct like_terms
+{
+  static constexpr bool compare()
+  {
+    if constexpr (is_numeric_coefficient_v<Sym1> || is_numeric_coefficient_v<Sym2>) {
+      return false;
+    } else if constexpr (term_hash<Sym1>::value != term_hash<Sym2>::value) {
+      return false;
+    } else {
+      return is_same_v<term_type_t<Sym1>, term_type_t<Sym2>>;
+    }
+  }
+
+  static constexpr bool value = compare();
+};
+
+template<typename Sym1, typename Sym2>
+constexpr bool like_terms_v = like_terms<Sym1,Sym2>::value;
+
+
+template<typename SymType>
+constexpr auto NegateCoefficient(const SymbolicBase<SymType>& c)
+{
+  if constexpr (SymType::is_dynamic) {
+    return RuntimeConstant(-c.derived().Value());
+  } else {
+    return -c.derived();
+  }
+}
+
+template<typename SymType>
+constexpr auto Coefficient(const SymbolicBase<SymType>& expr)
+{
+  if constexpr (is_negation_v<SymType>) {
+    return NegateCoefficient(Coefficient(expr.derived().Negate()));
+  }
+  else if constexpr (coefficient_split<SymType>::is_scaled) {
+    return get<0>(expr.derived());
+  }
+  else {
+    return One<>();
+  }
+}
+
+template<typename SymType>
+constexpr auto Term(const SymbolicBase<SymType>& expr)
+{
+  if constexpr (is_negation_v<SymType>) {
+    return Term(expr.derived().Negate());
+  }
+  else if constexpr (coefficient_split<SymType>::is_scaled) {
+    return expr.derived().template Without<0>();
+  }
+  else {
+    return expr.derived();
+  }
+}
+
+// Compile-time coefficients fold into a new Constant/IntegerFraction, runtime
+// ones are folded once here into a single RuntimeConstant
+template<typename C1, typename C2>
+constexpr auto AddCoefficients(const SymbolicBase<C1>& c1, const SymbolicBase<C2>& c2)
+{
+  if constexpr (C1::is_dynamic || C2::is_dynamic) {
+    typedef operation_return_t<coefficient_value_t<C1>, coefficient_value_t<C2>> ResultType;
+    return RuntimeConstant<ResultType>(
+      c1.derived().Evaluate(static_cast<ResultType>(0)) + c2.derived().Evaluate(static_cast<ResultType>(0)));
+  } else {
+    return c1.derived() + c2.derived();
+  }
+}
+
+
 template<typename Sym1, typename Sym2>
 struct SumCombinable
 {
@@ -20,7 +158,8 @@ struct SumCombinable
     is_zero_v<Sym1>
     || is_zero_v<Sym2>
     || (is_negation_v<Sym1> && is_negation_v<Sym2>)
-    || is_same_v<Sym1,Sym2>;
+    || is_same_v<Sym1,Sym2>
+    || like_terms_v<Sym1,Sym2>;
 };
 
 
@@ -98,126 +237,70 @@ struct SumCombinable<
 };
 
 
+// Sums are kept in canonical order, so equal sums match element by element.
+// Sums of different hashes are told apart without visiting their elements.
 template<class... Sym1, class... Sym2>
 struct is_same<TupleSum<Sym1...>,TupleSum<Sym2...>>
 {
-  template<std::size_t N, size_t M>
-  static constexpr bool find_value_impl()
+  static constexpr bool compare()
   {
-    if constexpr (is_same_v<NthTypeOf<N,Sym1...>,NthTypeOf<M,Sym2...>>) {
-      if constexpr ((N+1) < sizeof...(Sym1)) {
-        return find_value_impl<N+1,0>();
-      }
-      else {
-        return true;
-      }
-    }
-    else {
-      if constexpr ((M+1) < sizeof...(Sym2)) {
-        return find_value_impl<N,M+1>();
-      }
-      else {
-        return false;
-      }
+    if constexpr (sizeof...(Sym1) == sizeof...(Sym2) && hash_match_v<TupleSum<Sym1...>,TupleSum<Sym2...>>) {
+      return (is_same_v<Sym1,Sym2> && ...);
+    } else {
+      return false;
     }
   }
 
-  static constexpr bool value = find_value_impl<0,0>();
+  static constexpr bool value = compare();
 };
 
 
 // Helper Functions
-template<std::size_t N, typename Sym1, typename... Sym2>
-constexpr auto FactorCheck(const SymbolicBase<Sym1>& expr1, const TupleProduct<Sym2...>& expr2)
+// expr1 + expr2 with expr1 a factor of expr2 -> (1 + expr2 / expr1) * expr1
+template<typename Sym1, typename... Sym2>
+constexpr auto Factor(const SymbolicBase<Sym1>& expr1, const TupleProduct<Sym2...>& expr2)
 {
-  if constexpr (is_same_v<Sym1, NthTypeOf<N,Sym2...>>) {
+  constexpr std::size_t N = LastTrue<is_same_v<Sym1,Sym2>...>();
+  if constexpr (N < sizeof...(Sym2)) {
     return (One<>() + expr2.template Without<N>()) * expr1.derived();
   }
-  else if constexpr (N == 0) {
-    return TupleSum<Sym1, TupleProduct<Sym2...>>(expr1.derived(), expr2);
-  }
   else {
-    return FactorCheck<N-1, Sym1, Sym2...>(expr1, expr2);
+    return MakeCanonical<TupleSum>(expr1.derived(), expr2);
   }
 }
 
-template<typename Sym1, typename... Sym2>
-constexpr auto Factor(const SymbolicBase<Sym1>& expr1, const TupleProduct<Sym2...>& expr2)
-{
-  return FactorCheck<sizeof...(Sym2) - 1>(expr1, expr2);
-}
-
-
-template<std::size_t N, std::size_t M, typename... Sym1, typename... Sym2, std::size_t... I1, std::size_t... I2>
-auto FactorCheck(
+template<typename... Sym1, typename... Sym2, std::size_t... I1, std::size_t... I2>
+constexpr auto FactorCommon(
   const TupleProduct<Sym1...>& expr1,
   const TupleProduct<Sym2...>& expr2,
-  const std::index_sequence<I1...> i1,
-  const std::index_sequence<I2...> i2)
+  const std::index_sequence<I1...>,
+  const std::index_sequence<I2...>)
 {
-  if constexpr (is_same_v<NthTypeOf<N,Sym1...>,NthTypeOf<M,Sym2...>>) {
-    if constexpr ((N+1) < sizeof...(Sym1)) {
-      return FactorCheck<N+1,0>(expr1, expr2, std::index_sequence<I1..., N>(), std::index_sequence<I2..., M>());
-    }
-    else {
-      return expr1.template Subset<I1..., N>() *
-        ( expr1.template Without<I1..., N>() + expr2.template Without<I2..., M>() );
-    }
-  }
-  else {
-    if constexpr ((M+1) < sizeof...(Sym2)) {
-      return FactorCheck<N,M+1>(expr1, expr2, i1, i2);
-    }
-    else {
-      if constexpr ((N+1) < sizeof...(Sym1)) {
-        return FactorCheck<N+1,0>(expr1, expr2, i1, i2);
-      }
-      else {
-        return expr1.template Subset<I1...>() *
-          ( expr1.template Without<I1...>() + expr2.template Without<I2...>() );
-      }
-    }
-  }
+  return expr1.template Subset<I1...>() *
+    ( expr1.template Without<I1...>() + expr2.template Without<I2...>() );
 }
 
-template<std::size_t N, std::size_t M, typename... Sym1, typename... Sym2>
-constexpr auto FactorCheck(const TupleProduct<Sym1...>& expr1, const TupleProduct<Sym2...>& expr2)
+// Takes the factors common to both products out of their sum
+template<typename... Sym1, typename... Sym2>
+constexpr auto Factor(const TupleProduct<Sym1...>& expr1, const TupleProduct<Sym2...>& expr2)
 {
-  // change M for a given N
-  if constexpr (is_same_v<NthTypeOf<N, Sym1...>, NthTypeOf<M, Sym2...>>) {
-    if constexpr ((N+1) < sizeof...(Sym1)) {
-      return FactorCheck<N+1,0>(expr1, expr2, std::index_sequence<N>(), std::index_sequence<M>());
-    }
-    else {
-      return get<N>(expr1) * ( expr1.template Without<N>() + expr2.template Without<M>() );
-    }
+  constexpr auto common = greedy_pairs_v<is_same, type_list<Sym1...>, type_list<Sym2...>>;
+  if constexpr (common.size == 0) {
+    return MakeCanonical<TupleSum>(expr1, expr2);
+  }
+  else if constexpr (common.size == 1) {
+    return get<common.first[0]>(expr1) *
+      ( expr1.template Without<common.first[0]>() + expr2.template Without<common.second[0]>() );
   }
   else {
-    if constexpr ((M+1) < sizeof...(Sym2)) {
-      return FactorCheck<N,M+1>(expr1, expr2);
-    }
-    else {
-      if constexpr ((N+1) < sizeof...(Sym1)) {
-        return FactorCheck<N+1,0>(expr1, expr2);
-      }
-      else {
-        return TupleSum(expr1, expr2);
-      }
-    }
+    return FactorCommon(expr1, expr2, first_indices_t<common>(), second_indices_t<common>());
   }
 }
 
-template<typename... Sym1, typename... Sym2>
-constexpr auto Factor(const TupleProduct<Sym1...>& expr1, const TupleProduct<Sym2...>& expr2)
-{
-  return FactorCheck<0,0>(expr1,expr2);
-}
-
 
 // General Addition
 template<class Sym1, class Sym2>
-constexpr auto
-operator+(const SymbolicBase<Sym1>& expr1, const SymbolicBase<Sym2>& expr2)
+constexpr auto SumImpl(const SymbolicBase<Sym1>& expr1, const SymbolicBase<Sym2>& expr2)
 {
   if constexpr (is_zero_v<Sym1>) {
     return expr2.derived();
@@ -231,6 +314,9 @@ operator+(const SymbolicBase<Sym1>& expr1, const SymbolicBase<Sym2>& expr2)
   else if constexpr (is_same_v<Sym1,Sym2>) {
     return Int<2>() * expr1.derived();
   }
+  else if constexpr (like_terms_v<Sym1,Sym2>) {
+    return AddCoefficients(Coefficient(expr1), Coefficient(expr2)) * Term(expr1);
+  }
   // Factoring attempts start here
   else if constexpr (is_product_v<Sym1> && !is_product_v<Sym2>) {
     // if constexpr (is_sum_v<Sym2>) {
@@ -252,23 +338,30 @@ operator+(const SymbolicBase<Sym1>& expr1, const SymbolicBase<Sym2>& expr2)
     return Factor(expr1.derived(), expr2.derived());
   }
   else {
-    return TupleSum<Sym1,Sym2>(expr1.derived(), expr2.derived());
+    return MakeCanonical<TupleSum>(expr1.derived(), expr2.derived());
   }
 }
 
+// Every sum built goes through the construction rules, see ConstructionRules
+template<class Sym1, class Sym2>
+constexpr auto
+operator+(const SymbolicBase<Sym1>& expr1, const SymbolicBase<Sym2>& expr2)
+{
+  return ApplyConstructionRules(SumImpl(expr1, expr2));
+}
+
 
 // Sum of TupleSums
-template<std::size_t N, class Sym1, class... Sym2>
+// Merges expr1 into the last term it combines with, else adds it to the sum
+template<class Sym1, class... Sym2>
 constexpr auto extended_sum_impl(const SymbolicBase<Sym1>& expr1, const TupleSum<Sym2...>& expr2)
 {
-  if constexpr (SumCombinable<Sym1, NthTypeOf<N, Sym2...>>::value) {
+  constexpr std::size_t N = LastTrue<SumCombinable<Sym1, Sym2>::value...>();
+  if constexpr (N < sizeof...(Sym2)) {
     return expr2.template ModifyElement<N,Sym1>(expr1.derived());
   }
-  else if constexpr (N == 0) {
-    return ExtendTupleSum(expr1.derived(), expr2);
-  }
   else {
-    return extended_sum_impl<N-1,Sym1,Sym2...>(expr1, expr2);
+    return ExtendTupleSum(expr1.derived(), expr2);
   }
 }
 
@@ -276,72 +369,46 @@ template<class... Sym1, class Sym2>
 constexpr auto
 operator+(const TupleSum<Sym1...>& expr1, const SymbolicBase<Sym2>& expr2)
 {
-  return extended_sum_impl<sizeof...(Sym1)-1>(expr2.derived(), expr1);
+  return ApplyConstructionRules(extended_sum_impl(expr2.derived(), expr1));
 }
 
 template<class... Sym1, class Sym2>
 constexpr auto
 operator+(const SymbolicBase<Sym2>& expr1, const TupleSum<Sym1...>& expr2)
 {
-  return extended_sum_impl<sizeof...(Sym1)-1>(expr1.derived(), expr2);
+  return ApplyConstructionRules(extended_sum_impl(expr1.derived(), expr2));
 }
 
 
-template<std::size_t N, std::size_t M, std::size_t... I, class... Sym1, class... Sym2>
-constexpr auto merge_sums_impl2(const TupleSum<Sym1...>& expr1, const TupleSum<Sym2...>& expr2)
+// Term N of expr1, plus the term of expr2 paired with it
+template<auto Pairs, std::size_t N, class... Sym1, class... Sym2>
+constexpr auto merged_term(const TupleSum<Sym1...>& expr1, const TupleSum<Sym2...>& expr2)
 {
-  if constexpr (SumCombinable< NthTypeOf<N, Sym1...>, NthTypeOf<M, Sym2...> >::value) {
-    if constexpr ((N+1) < sizeof...(Sym1)) {
-      return merge_sums_impl2<N+1, 0, I..., M>(
-        expr1.template ModifyElement<N>(get<M>(expr2)), expr2);
-    }
-    else {
-      return ExtendTupleSum(
-        expr1.template ModifyElement<N>(get<M>(expr2)), expr2.template Without<I..., M>()
-        );
-    }
-  }
-  else {
-    if constexpr ((M+1) < sizeof...(Sym2)) {
-      return merge_sums_impl2<N,M+1,I...>(expr1, expr2);
-    }
-    else {
-      if constexpr ((N+1) < sizeof...(Sym1)) {
-        return merge_sums_impl2<N+1,0,I...>(expr1, expr2);
-      }
-      else {
-        return ExtendTupleSum(expr1, expr2.template Without<I...>());
-      }
-    }
+  constexpr std::size_t K = PairOf<Pairs>(N);
+  if constexpr (K < Pairs.size) {
+    return get<N>(expr1) + get<Pairs.second[K]>(expr2);
+  } else {
+    return get<N>(expr1);
   }
 }
 
-template<std::size_t N, std::size_t M, class... Sym1, class... Sym2>
-constexpr auto merge_sums_impl1(const TupleSum<Sym1...>& expr1, const TupleSum<Sym2...>& expr2)
+// Every term of expr1, merged with its pair, then the unpaired terms M... of
+// expr2. Terms that cancelled are dropped.
+template<auto Pairs, class... Sym1, class... Sym2, std::size_t... N, std::size_t... M>
+constexpr auto merge_sums_impl(
+  const TupleSum<Sym1...>& expr1,
+  const TupleSum<Sym2...>& expr2,
+  const std::index_sequence<N...>,
+  const std::index_sequence<M...>)
 {
-  if constexpr (SumCombinable< NthTypeOf<N, Sym1...>, NthTypeOf<M, Sym2...> >::value) {
-    if constexpr ((N+1) < sizeof...(Sym1)) {
-      return merge_sums_impl2<N+1, 0, M>(
-        expr1.template ModifyElement<N>(get<M>(expr2)), expr2);
-    }
-    else {
-      return ExtendTupleSum(
-        expr1.template ModifyElement<N>(get<M>(expr2)), expr2.template Without<M>()
-        );
-    }
-  }
-  else {
-    if constexpr ((M+1) < sizeof...(Sym2)) {
-      return merge_sums_impl1<N,M+1>(expr1, expr2);
-    }
-    else {
-      if constexpr ((N+1) < sizeof...(Sym1)) {
-        return merge_sums_impl1<N+1,0>(expr1, expr2);
-      }
-      else {
-        return ExtendTupleSum(expr1, expr2);
-      }
-    }
+  const auto terms = std::make_tuple(merged_term<Pairs,N>(expr1, expr2)..., get<M>(expr2)...);
+  constexpr auto kept = [&]<typename... Terms>(const std::tuple<Terms...>&) {
+    return SelectedIndices<!is_zero_v<Terms>...>();
+  }(terms);
+  if constexpr (kept.size == 0) {
+    return Zero<>();
+  } else {
+    return MakeTupleSum(terms, indices_t<kept>());
   }
 }
 
@@ -351,7 +418,11 @@ constexpr auto operator+(const TupleSum<Sym1...>& expr1, const TupleSum<Sym2...>
   if constexpr (is_same_v<TupleSum<Sym1...>,TupleSum<Sym2...>>) {
     return Int<2>() * expr1;
   } else {
-    return merge_sums_impl1<0,0>(expr1,expr2);
+    // each term of expr1 combines with the first free term of expr2 it can
+    constexpr auto pairs = greedy_pairs_v<SumCombinable, type_list<Sym1...>, type_list<Sym2...>>;
+    return ApplyConstructionRules(merge_sums_impl<pairs>(expr1, expr2,
+      std::index_sequence_for<Sym1...>(),
+      index_sequence_without<sizeof...(Sym2)>(second_indices_t<pairs>())));
   }
   // return TupleSum(expr1,expr2);
 }
@@ -17,6 +17,52 @@ struct BranchType
 };
 
 
+// A node is stateless when its type alone determines it, e.g. Sine<Symbol>
+template<typename SymType>
+constexpr bool is_stateless_v =
+  !SymType::is_dynamic && std::is_empty_v<SymType> && std::is_default_constructible_v<SymType>;
+
+// Storage of a child expression. Stateless children occupy no storage at all:
+// [[no_unique_address]] alone cannot overlap two subobjects of the same type, so
+// a fully static tree of nested Symbols would still take a byte per Symbol.
+// Access the child with * and ->.
+template<typename SymType, bool Stateless = is_stateless_v<SymType>>
+class Branch
+{
+private:
+  typename BranchType<SymType>::type expr_;
+
+public:
+  constexpr Branch(const SymType& expr) : expr_{expr}
+  {}
+
+  constexpr const SymType& operator*() const
+  { return expr_; }
+
+  constexpr const SymType* operator->() const
+  { return &expr_; }
+};
+
+template<typename SymType>
+class Branch<SymType, true>
+{
+private:
+  static constexpr SymType instance_ = SymType();
+
+public:
+  constexpr Branch() = default;
+
+  constexpr Branch(const SymType&)
+  {}
+
+  constexpr const SymType& operator*() const
+  { return instance_; }
+
+  constexpr const SymType* operator->() const
+  { return &instance_; }
+};
+
+
 template<class Derived>
 class SymbolicBase
 {
@@ -0,0 +1,746 @@
+#ifndef SYMBOLIC_INCLUDE_TAPE_HPP
+#define SYMBOLIC_INCLUDE_TAPE_HPP
+
+#include <map>
+#include <array>
+#include <tuple>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <concepts>
+#include <unordered_map>
+
+#include "symbolic_base.hpp"
+#include "prototyping.hpp"
+#include "constants.hpp"
+#include "ordering.hpp"
+#include "hash.hpp"
+#include "structure.hpp"
+#include "intern.hpp"
+#include "cost.hpp"
+#include "bind.hpp"
+
+
+#ifndef SYMBOLIC_DERIVATIVE_BUDGET
+#define SYMBOLIC_DERIVATIVE_BUDGET 256
+#endif
+
+
+namespace SYMBOLIC_NAMESPACE_NAME {
+
+// TAPE
+// Runtime form of an expression: a list of instructions, each writing one slot
+// from earlier slots, plus the constants and parameters they read. Its size is
+// not part of its type, so derivatives of any order compile to the same code.
+enum class TapeOp : std::uint8_t
+{
+  Input,
+  Constant,      // a: index of the constant
+  Parameter,     // a: index of the parameter, read at every evaluation
+  Add,
+  Subtract,
+  Multiply,
+  Divide,
+  Negate,
+  Power,
+  IntegerPower,  // b: exponent, see tape_max_integer_power
+  Sqrt,
+  Exp,
+  Log,
+  Sin,
+  Cos,
+  Tan,
+  Sec,
+  Cot,
+  Csc,
+  ArcSin,
+  ArcCos,
+  ArcTan,
+  ArcSec,
+  ArcCot,
+  ArcCsc,
+  Abs,
+  Sign
+};
+
+// Constant integer exponents up to this magnitude become IntegerPower
+// instructions; others, including the ones derivatives step past it, stay Power
+constexpr std::int32_t tape_max_integer_power = 64;
+
+struct TapeInstruction
+{
+  TapeOp op;
+  std::uint32_t a = 0;
+  std::uint32_t b = 0;
+
+  constexpr bool operator==(const TapeInstruction&) const = default;
+};
+
+// Value of an arithmetic or function instruction over operand values a and b
+template<typename FloatType>
+FloatType ApplyTapeOp(const TapeInstruction& ins, const FloatType a, const FloatType b)
+{
+  using std::pow; using std::sqrt; using std::exp; using std::log;
+  using std::sin; using std::cos; using std::tan;
+  using std::asin; using std::acos; using std::atan; using std::abs;
+  const FloatType one = static_cast<FloatType>(1);
+  switch (ins.op) {
+    case TapeOp::Add:       return a + b;
+    case TapeOp::Subtract:  return a - b;
+    case TapeOp::Multiply:  return a * b;
+    case TapeOp::Divide:    return a / b;
+    case TapeOp::Negate:    return -a;
+    case TapeOp::Power:     return pow(a, b);
+    case TapeOp::IntegerPower: {
+      const std::int32_t n = static_cast<std::int32_t>(ins.b);
+      std::uint32_t k = (n < 0) ? 0u - ins.b : ins.b;
+      FloatType result = one;
+      FloatType base = a;
+      for (; k != 0; k >>= 1, base *= base) {
+        if (k & 1) {
+          result *= base;
+        }
+      }
+      return (n < 0) ? one / result : result;
+    }
+    case TapeOp::Sqrt:      return sqrt(a);
+    case TapeOp::Exp:       return exp(a);
+    case TapeOp::Log:       return log(a);
+    case TapeOp::Sin:       return sin(a);
+    case TapeOp::Cos:       return cos(a);
+    case TapeOp::Tan:       return tan(a);
+    case TapeOp::Sec:       return one / cos(a);
+    case TapeOp::Cot:       return one / tan(a);
+    case TapeOp::Csc:       return one / sin(a);
+    case TapeOp::ArcSin:    return asin(a);
+    case TapeOp::ArcCos:    return acos(a);
+    case TapeOp::ArcTan:    return atan(a);
+    case TapeOp::ArcSec:    return acos(one / a);
+    case TapeOp::ArcCot:    return atan(one / a);
+    case TapeOp::ArcCsc:    return asin(one / a);
+    case TapeOp::Abs:       return abs(a);
+    case TapeOp::Sign:      return (a < static_cast<FloatType>(0)) ? -one : one;
+    default:                return static_cast<FloatType>(0);
+  }
+}
+
+constexpr bool IsBinaryTapeOp(const TapeOp op)
+{
+  return op == TapeOp::Add || op == TapeOp::Subtract || op == TapeOp::Multiply
+    || op == TapeOp::Divide || op == TapeOp::Power;
+}
+
+inline const char* TapeOpName(const TapeOp op)
+{
+  constexpr const char* names[] = {
+    "x", "const", "param", "+", "-", "*", "/", "-", "^", "^", "sqrt", "exp", "ln",
+    "sin", "cos", "tan", "sec", "cot", "csc", "arcsin", "arccos", "arctan",
+    "arcsec", "arccot", "arccsc", "abs", "sgn" };
+  return names[static_cast<std::size_t>(op)];
+}
+
+template<typename T>
+struct TapeParameter
+{
+  const void* address;
+  T (*read)(const void*);
+};
+
+
+template<typename T>
+class TapeBuilder;
+
+// An expression held as a tape. Evaluate interprets the instructions; each
+// Derivative builds a new tape with shared subexpressions merged and constants
+// folded. Parameters are read by address at every evaluation, and are not
+// reported by ReferenceAddresses.
+template<typename T = double>
+class Tape : public SymbolicBase< Tape<T> >
+{
+private:
+  // One instruction per slot, in slot order; derivatives are taken on this form
+  std::vector<TapeInstruction> code_;
+  std::vector<T> constants_;
+  std::vector<TapeParameter<T>> parameters_;
+
+  // Evaluation order: the buffer starts with the constants, the parameters and
+  // the input, followed by one value per program instruction, whose operands
+  // are buffer positions
+  std::vector<TapeInstruction> program_;
+  std::uint32_t result_ = 0;
+
+  friend class TapeBuilder<T>;
+
+  std::uint32_t Leaves() const
+  { return static_cast<std::uint32_t>(constants_.size() + parameters_.size() + 1); }
+
+  void Compile()
+  {
+    const std::uint32_t input = static_cast<std::uint32_t>(constants_.size() + parameters_.size());
+    std::vector<std::uint32_t> position(code_.size());
+    program_.clear();
+    for (std::size_t i = 0; i < code_.size(); ++i) {
+      TapeInstruction ins = code_[i];
+      switch (ins.op) {
+        case TapeOp::Input:     position[i] = input; break;
+        case TapeOp::Constant:  position[i] = ins.a; break;
+        case TapeOp::Parameter: position[i] = static_cast<std::uint32_t>(constants_.size()) + ins.a; break;
+        default:
+          ins.a = position[ins.a];
+          if (IsBinaryTapeOp(ins.op)) {
+            ins.b = position[ins.b];
+          }
+          position[i] = Leaves() + static_cast<std::uint32_t>(program_.size());
+          program_.push_back(ins);
+      }
+    }
+    result_ = position.back();
+  }
+
+  template<typename FloatType>
+  FloatType Run(FloatType* v, const FloatType input) const
+  {
+    FloatType* out = v;
+    for (const T c : constants_) {
+      *out++ = static_cast<FloatType>(c);
+    }
+    for (const TapeParameter<T>& p : parameters_) {
+      *out++ = static_cast<FloatType>(p.read(p.address));
+    }
+    *out++ = input;
+    for (const TapeInstruction& ins : program_) {
+      switch (ins.op) {
+        case TapeOp::Add:       *out = v[ins.a] + v[ins.b]; break;
+        case TapeOp::Subtract:  *out = v[ins.a] - v[ins.b]; break;
+        case TapeOp::Multiply:  *out = v[ins.a] * v[ins.b]; break;
+        case TapeOp::Divide:    *out = v[ins.a] / v[ins.b]; break;
+        case TapeOp::Negate:    *out = -v[ins.a]; break;
+        case TapeOp::Power:     *out = ApplyTapeOp(ins, v[ins.a], v[ins.b]); break;
+        default:                *out = ApplyTapeOp(ins, v[ins.a], FloatType{});
+      }
+      ++out;
+    }
+    return v[result_];
+  }
+
+public:
+  static constexpr bool is_leaf = false;
+  static constexpr bool is_dynamic = true;
+
+  // Values this many or fewer are kept on the stack during Evaluate
+  static constexpr std::size_t stack_values = 64;
+
+  Tape() : code_{ TapeInstruction{TapeOp::Constant, 0, 0} }, constants_{ static_cast<T>(0) }
+  {
+    Compile();
+  }
+
+  template<typename FloatType>
+  FloatType Evaluate(const FloatType input) const
+  {
+    const std::size_t size = Leaves() + program_.size();
+    if (size <= stack_values) {
+      FloatType values[stack_values];
+      return Run(values, input);
+    } else {
+      std::vector<FloatType> values(size);
+      return Run(values.data(), input);
+    }
+  }
+
+  Tape Derivative() const;
+
+  std::string str() const
+  {
+    std::string out = "tape(";
+    for (std::size_t i = 0; i < code_.size(); ++i) {
+      const TapeInstruction& ins = code_[i];
+      out += "t" + std::to_string(i) + " = ";
+      switch (ins.op) {
+        case TapeOp::Input:     out += "x"; break;
+        case TapeOp::Constant:  out += std::to_string(constants_[ins.a]); break;
+        case TapeOp::Parameter: out += "p" + std::to_string(ins.a); break;
+        case TapeOp::Negate:    out += "-t" + std::to_string(ins.a); break;
+        case TapeOp::IntegerPower:
+          out += "t" + std::to_string(ins.a) + " ^ " + std::to_string(static_cast<std::int32_t>(ins.b));
+          break;
+        default:
+          if (IsBinaryTapeOp(ins.op)) {
+            out += "t" + std::to_string(ins.a) + " " + TapeOpName(ins.op) + " t" + std::to_string(ins.b);
+          } else {
+            out += std::string(TapeOpName(ins.op)) + "(t" + std::to_string(ins.a) + ")";
+          }
+      }
+      out += (i + 1 < code_.size()) ? "; " : ")";
+    }
+    return out;
+  }
+
+  // Number of instructions
+  std::size_t Size() const
+  { return code_.size(); }
+
+  const std::vector<TapeInstruction>& Instructions() const
+  { return code_; }
+
+  const std::vector<T>& Constants() const
+  { return constants_; }
+};
+
+
+// Appends instructions to a tape, reusing identical ones and folding constants
+template<typename T>
+class TapeBuilder
+{
+private:
+  struct InstructionHash
+  {
+    std::size_t operator()(const TapeInstruction& ins) const
+    {
+      return HashCombine(HashCombine(static_cast<std::uint64_t>(ins.op), ins.a), ins.b);
+    }
+  };
+
+  Tape<T> tape_;
+  std::unordered_map<TapeInstruction, std::uint32_t, InstructionHash> slots_;
+  std::map<std::array<unsigned char, sizeof(T)>, std::uint32_t> constant_slots_;
+
+  std::uint32_t Append(const TapeInstruction& ins)
+  {
+    const auto [it, inserted] = slots_.try_emplace(ins, static_cast<std::uint32_t>(tape_.code_.size()));
+    if (inserted) {
+      tape_.code_.push_back(ins);
+    }
+    return it->second;
+  }
+
+  const TapeInstruction& At(const std::uint32_t slot) const
+  { return tape_.code_[slot]; }
+
+public:
+  TapeBuilder()
+  {
+    tape_.code_.clear();
+    tape_.constants_.clear();
+  }
+
+  bool IsConstant(const std::uint32_t slot) const
+  { return At(slot).op == TapeOp::Constant; }
+
+  T ConstantValue(const std::uint32_t slot) const
+  { return tape_.constants_[At(slot).a]; }
+
+  bool IsConstant(const std::uint32_t slot, const T value) const
+  { return IsConstant(slot) && ConstantValue(slot) == value; }
+
+  std::uint32_t Input()
+  { return Append({TapeOp::Input, 0, 0}); }
+
+  std::uint32_t Constant(const T value)
+  {
+    const auto key = std::bit_cast<std::array<unsigned char, sizeof(T)>>(value);
+    const auto [it, inserted] = constant_slots_.try_emplace(key, 0);
+    if (inserted) {
+      tape_.constants_.push_back(value);
+      it->second = Append({TapeOp::Constant, static_cast<std::uint32_t>(tape_.constants_.size() - 1), 0});
+    }
+    return it->second;
+  }
+
+  template<typename U>
+  std::uint32_t Parameter(const U* address)
+  {
+    auto& parameters = tape_.parameters_;
+    std::uint32_t index = 0;
+    while (index < parameters.size() && parameters[index].address != address) {
+      ++index;
+    }
+    if (index == parameters.size()) {
+      parameters.push_back({address, [](const void* p) { return static_cast<T>(*static_cast<const U*>(p)); }});
+    }
+    return Append({TapeOp::Parameter, index, 0});
+  }
+
+  std::uint32_t Unary(const TapeOp op, const std::uint32_t a)
+  {
+    if (IsConstant(a)) {
+      return Constant(ApplyTapeOp(TapeInstruction{op, 0, 0}, ConstantValue(a), T{}));
+    }
+    if (op == TapeOp::Negate && At(a).op == TapeOp::Negate) {
+      return At(a).a;
+    }
+    return Append({op, a, 0});
+  }
+
+  std::uint32_t Binary(const TapeOp op, const std::uint32_t a, const std::uint32_t b)
+  {
+    if (IsConstant(a) && IsConstant(b)) {
+      return Constant(ApplyTapeOp(TapeInstruction{op, 0, 0}, ConstantValue(a), ConstantValue(b)));
+    }
+    switch (op) {
+      case TapeOp::Add:
+        if (IsConstant(a, 0)) { return b; }
+        if (IsConstant(b, 0)) { return a; }
+        if (At(b).op == TapeOp::Negate) { return Binary(TapeOp::Subtract, a, At(b).a); }
+        break;
+      case TapeOp::Subtract:
+        if (a == b) { return Constant(0); }
+        if (IsConstant(a, 0)) { return Unary(TapeOp::Negate, b); }
+        if (IsConstant(b, 0)) { return a; }
+        break;
+      case TapeOp::Multiply:
+        if (IsConstant(a, 0) || IsConstant(b, 0)) { return Constant(0); }
+        if (IsConstant(a, 1)) { return b; }
+        if (IsConstant(b, 1)) { return a; }
+        if (IsConstant(a, -1)) { return Unary(TapeOp::Negate, b); }
+        if (IsConstant(b, -1)) { return Unary(TapeOp::Negate, a); }
+        // operands in slot order, so a*b and b*a are one instruction
+        if (b < a) { return Append({op, b, a}); }
+        break;
+      case TapeOp::Divide:
+        if (IsConstant(a, 0)) { return Constant(0); }
+        if (IsConstant(b, 1)) { return a; }
+        break;
+      case TapeOp::Power:
+        if (IsConstant(b)) {
+          const T n = ConstantValue(b);
+          // range first: NaN, infinite and huge exponents don't convert
+          if (std::abs(n) <= static_cast<T>(tape_max_integer_power) && std::trunc(n) == n) {
+            return IntegerPower(a, static_cast<std::int32_t>(n));
+          }
+          if (n == static_cast<T>(0.5)) {
+            return Unary(TapeOp::Sqrt, a);
+          }
+        }
+        break;
+      default:
+        break;
+    }
+    if (op == TapeOp::Add && b < a) {
+      return Append({op, b, a});
+    }
+    return Append({op, a, b});
+  }
+
+  std::uint32_t IntegerPower(const std::uint32_t a, const std::int32_t n)
+  {
+    if (n == 0) {
+      return Constant(1);
+    }
+    if (n == 1) {
+      return a;
+    }
+    if (IsConstant(a)) {
+      return Constant(ApplyTapeOp(TapeInstruction{TapeOp::IntegerPower, 0, static_cast<std::uint32_t>(n)}, ConstantValue(a), T{}));
+    }
+    return Append({TapeOp::IntegerPower, a, static_cast<std::uint32_t>(n)});
+  }
+
+  std::uint32_t Add(const std::uint32_t a, const std::uint32_t b)      { return Binary(TapeOp::Add, a, b); }
+  std::uint32_t Subtract(const std::uint32_t a, const std::uint32_t b) { return Binary(TapeOp::Subtract, a, b); }
+  std::uint32_t Multiply(const std::uint32_t a, const std::uint32_t b) { return Binary(TapeOp::Multiply, a, b); }
+  std::uint32_t Divide(const std::uint32_t a, const std::uint32_t b)   { return Binary(TapeOp::Divide, a, b); }
+  std::uint32_t Negate(const std::uint32_t a)                          { return Unary(TapeOp::Negate, a); }
+
+  // Copies the instructions of tape, returning the slot of its result
+  std::uint32_t Splice(const Tape<T>& tape)
+  {
+    std::vector<std::uint32_t> slot(tape.code_.size());
+    for (std::size_t i = 0; i < tape.code_.size(); ++i) {
+      const TapeInstruction& ins = tape.code_[i];
+      switch (ins.op) {
+        case TapeOp::Input:
+          slot[i] = Input();
+          break;
+        case TapeOp::Constant:
+          slot[i] = Constant(tape.constants_[ins.a]);
+          break;
+        case TapeOp::Parameter: {
+          const TapeParameter<T>& p = tape.parameters_[ins.a];
+          std::uint32_t index = 0;
+          while (index < tape_.parameters_.size() && tape_.parameters_[index].address != p.address) {
+            ++index;
+          }
+          if (index == tape_.parameters_.size()) {
+            tape_.parameters_.push_back(p);
+          }
+          slot[i] = Append({TapeOp::Parameter, index, 0});
+          break;
+        }
+        case TapeOp::IntegerPower:
+          slot[i] = IntegerPower(slot[ins.a], static_cast<std::int32_t>(ins.b));
+          break;
+        default:
+          slot[i] = IsBinaryTapeOp(ins.op) ? Binary(ins.op, slot[ins.a], slot[ins.b]) : Unary(ins.op, slot[ins.a]);
+      }
+    }
+    return slot.back();
+  }
+
+  // Appends the derivative of slot result, differentiating forward through
+  // every slot it is computed from
+  std::uint32_t Derive(const std::uint32_t result)
+  {
+    std::vector<std::uint32_t> d(result + 1);
+    const std::uint32_t zero = Constant(0);
+    const std::uint32_t one = Constant(1);
+    for (std::uint32_t i = 0; i <= result; ++i) {
+      const TapeInstruction ins = At(i);
+      const std::uint32_t a = ins.a;
+      const std::uint32_t b = ins.b;
+      const auto da = [&]() { return d[a]; };
+      switch (ins.op) {
+        case TapeOp::Input:     d[i] = one; break;
+        case TapeOp::Constant:
+        case TapeOp::Parameter: d[i] = zero; break;
+        case TapeOp::Add:       d[i] = Add(d[a], d[b]); break;
+        case TapeOp::Subtract:  d[i] = Subtract(d[a], d[b]); break;
+        case TapeOp::Multiply:  d[i] = Add(Multiply(d[a], b), Multiply(a, d[b])); break;
+        case TapeOp::Divide:
+          // (a/b)' = (a' - (a/b) b') / b
+          d[i] = Divide(Subtract(d[a], Multiply(i, d[b])), b);
+          break;
+        case TapeOp::Negate:    d[i] = Negate(da()); break;
+        case TapeOp::Power:
+          // (a^b)' = a^b (b' ln a + b a' / a)
+          d[i] = Multiply(i, Add(Multiply(d[b], Unary(TapeOp::Log, a)), Divide(Multiply(b, da()), a)));
+          break;
+        case TapeOp::IntegerPower: {
+          const std::int32_t n = static_cast<std::int32_t>(b);
+          d[i] = Multiply(Multiply(Constant(static_cast<T>(n)), Binary(TapeOp::Power, a, Constant(static_cast<T>(n - 1)))), da());
+          break;
+        }
+        case TapeOp::Sqrt:      d[i] = Divide(da(), Multiply(Constant(2), i)); break;
+        case TapeOp::Exp:       d[i] = Multiply(i, da()); break;
+        case TapeOp::Log:       d[i] = Divide(da(), a); break;
+        case TapeOp::Sin:       d[i] = Multiply(Unary(TapeOp::Cos, a), da()); break;
+        case TapeOp::Cos:       d[i] = Negate(Multiply(Unary(TapeOp::Sin, a), da())); break;
+        case TapeOp::Tan:       d[i] = Multiply(Add(one, IntegerPower(i, 2)), da()); break;
+        case TapeOp::Sec:       d[i] = Multiply(Multiply(i, Unary(TapeOp::Tan, a)), da()); break;
+        case TapeOp::Cot:       d[i] = Negate(Multiply(Add(one, IntegerPower(i, 2)), da())); break;
+        case TapeOp::Csc:       d[i] = Negate(Multiply(Multiply(i, Unary(TapeOp::Cot, a)), da())); break;
+        case TapeOp::ArcSin:
+          d[i] = Divide(da(), Unary(TapeOp::Sqrt, Subtract(one, IntegerPower(a, 2))));
+          break;
+        case TapeOp::ArcCos:
+          d[i] = Negate(Divide(da(), Unary(TapeOp::Sqrt, Subtract(one, IntegerPower(a, 2)))));
+          break;
+        case TapeOp::ArcTan:    d[i] = Divide(da(), Add(one, IntegerPower(a, 2))); break;
+        case TapeOp::ArcCot:    d[i] = Negate(Divide(da(), Add(one, IntegerPower(a, 2)))); break;
+        case TapeOp::ArcSec:
+        case TapeOp::ArcCsc: {
+          // arcsec' = 1 / (|a| sqrt(a^2 - 1)), arccsc' = -arcsec'
+          const std::uint32_t magnitude = Multiply(Unary(TapeOp::Abs, a), Unary(TapeOp::Sqrt, Subtract(IntegerPower(a, 2), one)));
+          const std::uint32_t derivative = Divide(da(), magnitude);
+          d[i] = (ins.op == TapeOp::ArcSec) ? derivative : Negate(derivative);
+          break;
+        }
+        case TapeOp::Abs:       d[i] = Multiply(Unary(TapeOp::Sign, a), da()); break;
+        case TapeOp::Sign:      d[i] = zero; break;
+      }
+    }
+    return d[result];
+  }
+
+  // The tape computing slot result, without the instructions it doesn't use
+  Tape<T> Finish(const std::uint32_t result) const
+  {
+    const std::vector<TapeInstruction>& code = tape_.code_;
+    std::vector<bool> live(result + 1, false);
+    live[result] = true;
+    for (std::uint32_t i = result + 1; i-- > 0;) {
+      const TapeInstruction& ins = code[i];
+      if (!live[i] || ins.op == TapeOp::Input || ins.op == TapeOp::Constant || ins.op == TapeOp::Parameter) {
+        continue;
+      }
+      live[ins.a] = true;
+      if (IsBinaryTapeOp(ins.op)) {
+        live[ins.b] = true;
+      }
+    }
+
+    Tape<T> out;
+    out.code_.clear();
+    out.constants_.clear();
+    out.parameters_ = tape_.parameters_;
+    std::vector<std::uint32_t> slot(result + 1);
+    for (std::uint32_t i = 0; i <= result; ++i) {
+      if (!live[i]) {
+        continue;
+      }
+      TapeInstruction ins = code[i];
+      if (ins.op == TapeOp::Constant) {
+        out.constants_.push_back(tape_.constants_[ins.a]);
+        ins.a = static_cast<std::uint32_t>(out.constants_.size() - 1);
+      } else if (ins.op != TapeOp::Input && ins.op != TapeOp::Parameter) {
+        ins.a = slot[ins.a];
+        if (IsBinaryTapeOp(ins.op)) {
+          ins.b = slot[ins.b];
+        }
+      }
+      slot[i] = static_cast<std::uint32_t>(out.code_.size());
+      out.code_.push_back(ins);
+    }
+    out.Compile();
+    return out;
+  }
+};
+
+
+template<typename T>
+Tape<T> Tape<T>::Derivative() const
+{
+  TapeBuilder<T> builder;
+  const std::uint32_t result = builder.Splice(*this);
+  return builder.Finish(builder.Derive(result));
+}
+
+
+template<typename SymType>
+constexpr TapeOp UnaryTapeOp()
+{
+  constexpr NodeKind kind = node_kind_v<SymType>;
+  if constexpr (kind == NodeKind::Sine)               { return TapeOp::Sin; }
+  else if constexpr (kind == NodeKind::Cosine)        { return TapeOp::Cos; }
+  else if constexpr (kind == NodeKind::Tangent)       { return TapeOp::Tan; }
+  else if constexpr (kind == NodeKind::Secant)        { return TapeOp::Sec; }
+  else if constexpr (kind == NodeKind::Cotangent)     { return TapeOp::Cot; }
+  else if constexpr (kind == NodeKind::Cosecant)      { return TapeOp::Csc; }
+  else if constexpr (kind == NodeKind::ArcSine)       { return TapeOp::ArcSin; }
+  else if constexpr (kind == NodeKind::ArcCosine)     { return TapeOp::ArcCos; }
+  else if constexpr (kind == NodeKind::ArcTangent)    { return TapeOp::ArcTan; }
+  else if constexpr (kind == NodeKind::ArcSecant)     { return TapeOp::ArcSec; }
+  else if constexpr (kind == NodeKind::ArcCotangent)  { return TapeOp::ArcCot; }
+  else if constexpr (kind == NodeKind::ArcCosecant)   { return TapeOp::ArcCsc; }
+  else if constexpr (kind == NodeKind::AbsoluteValue) { return TapeOp::Abs; }
+  else                                                { return TapeOp::Sign; }
+}
+
+// Appends expr to builder, returning the slot of its value. Subtrees without
+// the input or parameters are evaluated once into constants.
+template<typename T, typename SymType>
+std::uint32_t EmitTape(TapeBuilder<T>& builder, const SymbolicBase<SymType>& expr)
+{
+  constexpr NodeKind kind = node_kind_v<SymType>;
+  const SymType& node = expr.derived();
+  if constexpr (std::is_same_v<SymType, Tape<T>>) {
+    return builder.Splice(node);
+  }
+  // nodes that lower themselves, such as AnyExpression
+  else if constexpr (requires { { node.ToTape() } -> std::same_as<Tape<T>>; }) {
+    return builder.Splice(node.ToTape());
+  }
+  else if constexpr (is_interned_v<SymType>) {
+    return EmitTape(builder, node.Node());
+  }
+  else if constexpr (is_bound_v<SymType>) {
+    return EmitTape(builder, node.Expression());
+  }
+  else if constexpr (!depends_on_input_v<SymType>
+      && std::tuple_size_v<decltype(ReferenceAddresses(node))> == 0) {
+    return builder.Constant(node.Evaluate(static_cast<T>(0)));
+  }
+  else if constexpr (kind == NodeKind::Symbol) {
+    return builder.Input();
+  }
+  else if constexpr (kind == NodeKind::Reference) {
+    return builder.Parameter(node.Address());
+  }
+  else if constexpr (kind == NodeKind::Negation) {
+    return builder.Negate(EmitTape(builder, node.Argument()));
+  }
+  else if constexpr (kind == NodeKind::Sum || kind == NodeKind::Product) {
+    return std::apply([&](const auto& first, const auto&... rest) {
+      std::uint32_t slot = EmitTape(builder, first);
+      ((slot = (kind == NodeKind::Sum)
+        ? builder.Add(slot, EmitTape(builder, rest))
+        : builder.Multiply(slot, EmitTape(builder, rest))), ...);
+      return slot;
+    }, Children(node));
+  }
+  else if constexpr (is_product_derivative_v<SymType>) {
+    return builder.Derive(std::apply([&](const auto& first, const auto&... rest) {
+      std::uint32_t slot = EmitTape(builder, first);
+      ((slot = builder.Multiply(slot, EmitTape(builder, rest))), ...);
+      return slot;
+    }, Children(node)));
+  }
+  else if constexpr (kind == NodeKind::Quotient) {
+    return builder.Divide(EmitTape(builder, node.Numerator()), EmitTape(builder, node.Denominator()));
+  }
+  else if constexpr (kind == NodeKind::Exponential) {
+    typedef std::decay_t<decltype(node.Base())> BaseType;
+    if constexpr (is_constant_e_v<BaseType>) {
+      return builder.Unary(TapeOp::Exp, EmitTape(builder, node.Exponent()));
+    } else {
+      return builder.Binary(TapeOp::Power, EmitTape(builder, node.Base()), EmitTape(builder, node.Exponent()));
+    }
+  }
+  else if constexpr (kind == NodeKind::Logarithm) {
+    typedef std::decay_t<decltype(node.Base())> BaseType;
+    const std::uint32_t log = builder.Unary(TapeOp::Log, EmitTape(builder, node.Argument()));
+    if constexpr (is_constant_e_v<BaseType>) {
+      return log;
+    } else {
+      return builder.Divide(log, builder.Unary(TapeOp::Log, EmitTape(builder, node.Base())));
+    }
+  }
+  else {
+    static_assert(kind != NodeKind::Unknown, "EmitTape: node type has no tape instruction");
+    return builder.Unary(UnaryTapeOp<SymType>(), EmitTape(builder, node.Argument()));
+  }
+}
+
+// expr as a tape evaluating in T
+template<typename T = double, typename SymType>
+Tape<T> ToTape(const SymbolicBase<SymType>& expr)
+{
+  TapeBuilder<T> builder;
+  return builder.Finish(EmitTape(builder, expr));
+}
+
+template<typename T>
+struct node_children<Tape<T>>
+{
+  typedef type_list<> type;
+};
+
+template<typename T>
+struct depends_on_input<Tape<T>>
+{
+  static constexpr bool value = true;
+};
+
+
+// N-TH DERIVATIVE
+// Static derivatives as long as the next one has at most Budget nodes (see
+// node_count_v); past that, the remaining orders are taken on a tape of the
+// last static derivative. Either way the result is evaluated the same.
+template<std::size_t N, std::size_t Budget = SYMBOLIC_DERIVATIVE_BUDGET, typename T = double, typename SymType>
+constexpr auto Derivative(const SymbolicBase<SymType>& expr)
+{
+  if constexpr (N == 0) {
+    return expr.derived();
+  }
+  else if constexpr (std::is_same_v<SymType, Tape<T>>) {
+    Tape<T> tape = expr.derived();
+    for (std::size_t k = 0; k < N; ++k) {
+      tape = tape.Derivative();
+    }
+    return tape;
+  }
+  else if constexpr (node_count_v<decltype(expr.Derivative())> <= Budget) {
+    return Derivative<N-1, Budget, T>(expr.Derivative());
+  }
+  else {
+    return Derivative<N, Budget, T>(ToTape<T>(expr));
+  }
+}
+
+
+} // Symbolic namespace
+#endif
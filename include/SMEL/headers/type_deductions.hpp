@@ -56,6 +56,56 @@ struct is_constant_e<constant_e<T>>
 template<typename T>
 constexpr bool is_constant_e_v = is_constant_e<T>::value;
 
+// IS NUMERIC COEFFICIENT
+template<typename SymType>
+struct is_numeric_coefficient
+{
+  static constexpr bool value = false;
+};
+
+template<typename T, T Val>
+struct is_numeric_coefficient<Constant<T,Val>>
+{
+  static constexpr bool value = true;
+};
+
+template<typename T1, T1 Val1, typename T2, T2 Val2>
+struct is_numeric_coefficient< Quotient<Constant<T1,Val1>, Constant<T2,Val2>> >
+{
+  static constexpr bool value = true;
+};
+
+template<typename T>
+struct is_numeric_coefficient<RuntimeConstant<T>>
+{
+  static constexpr bool value = true;
+};
+
+template<typename SymType>
+constexpr bool is_numeric_coefficient_v = is_numeric_coefficient<SymType>::value;
+
+// Value type of a numeric coefficient
+template<typename SymType>
+struct coefficient_value
+{
+  typedef double type;
+};
+
+template<typename T, T Val>
+struct coefficient_value<Constant<T,Val>>
+{
+  typedef T type;
+};
+
+template<typename T>
+struct coefficient_value<RuntimeConstant<T>>
+{
+  typedef T type;
+};
+
+template<typename SymType>
+using coefficient_value_t = typename coefficient_value<SymType>::type;
+
 // HAS ZERO DERIVATIVE
 template<typename T>
 struct zero_derivative
@@ -198,6 +248,61 @@ struct is_product<TupleProduct<Syms...>>
 template<typename SymType>
 constexpr bool is_product_v = is_product<SymType>::value;
 
+// IS QUOTIENT
+// Numeric fractions are constants rather than quotients of expressions
+template<typename SymType>
+struct is_quotient
+{
+  static constexpr bool value = false;
+};
+
+template<typename Sym1, typename Sym2>
+struct is_quotient<Quotient<Sym1,Sym2>>
+{
+  static constexpr bool value = true;
+};
+
+template<typename T1, T1 Val1, typename T2, T2 Val2>
+struct is_quotient< Quotient<Constant<T1,Val1>, Constant<T2,Val2>> >
+{
+  static constexpr bool value = false;
+};
+
+template<typename SymType>
+constexpr bool is_quotient_v = is_quotient<SymType>::value;
+
+// IS EXPONENTIAL
+template<typename SymType>
+struct is_exponential
+{
+  static constexpr bool value = false;
+};
+
+template<typename Sym1, typename Sym2>
+struct is_exponential<Exponential<Sym1,Sym2>>
+{
+  static constexpr bool value = true;
+};
+
+template<typename SymType>
+constexpr bool is_exponential_v = is_exponential<SymType>::value;
+
+// IS ONE HALF
+template<typename SymType>
+struct is_one_half
+{
+  static constexpr bool value = false;
+};
+
+template<typename T1, T1 Val1, typename T2, T2 Val2>
+struct is_one_half< Quotient<Constant<T1,Val1>, Constant<T2,Val2>> >
+{
+  static constexpr bool value = (Val1 != 0) && (static_cast<T2>(2 * Val1) == Val2);
+};
+
+template<typename SymType>
+constexpr bool is_one_half_v = is_one_half<SymType>::value;
+
 
 } // Symbolic namespace
 #endif
\ No newline at end of file
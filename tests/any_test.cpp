@@ -0,0 +1,166 @@
+// AnyExpression: copies and moves between inline and heap storage, containers
+// of mixed handles, EvaluateBatch, and derivatives past the static depth
+
+#include <span>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "SMEL/Expressions"
+#include "check.hpp"
+
+using namespace SYMBOLIC_NAMESPACE_NAME;
+
+
+// Twelve runtime constants: larger than the inline buffer
+static auto LargeExpression()
+{
+  const Symbol x;
+  typedef RuntimeConstant<double> C;
+  return C(1.0) * sin(C(0.5) * x) + C(2.0) * cos(C(1.5) * x)
+    + C(0.25) * exp(C(0.1) * x) + C(3.0) / (C(4.0) + x * x)
+    + C(0.75) * arctan(C(2.5) * x) + C(1.25) * pow<3>(x + C(0.2));
+}
+
+// handle against expr at inputs over [-2, 2]
+template<typename SymType>
+static bool Same(const AnyExpression<>& handle, const SymType& expr)
+{
+  for (int i = 0; i <= 16; ++i) {
+    const double x = -2 + 0.25 * i;
+    if (!check::Near(handle.Evaluate(x), expr.Evaluate(x), 1e-14, "handle value", __FILE__, __LINE__)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+static void Storage()
+{
+  const Symbol x;
+  const auto small = sin(x) * exp(x);
+  const auto large = LargeExpression();
+  const AnyExpression<> inline_handle = small;
+  const AnyExpression<> heap_handle = large;
+  SMEL_CHECK(inline_handle.IsInline());
+  SMEL_CHECK(!heap_handle.IsInline());
+  SMEL_CHECK(Same(inline_handle, small));
+  SMEL_CHECK(Same(heap_handle, large));
+
+  // Copies keep the storage of their source and are independent of it
+  AnyExpression<> inline_copy = inline_handle;
+  AnyExpression<> heap_copy = heap_handle;
+  SMEL_CHECK(inline_copy.IsInline() && !heap_copy.IsInline());
+  SMEL_CHECK(Same(inline_copy, small) && Same(heap_copy, large));
+
+  // Assignment across storage kinds, both ways
+  inline_copy = heap_handle;
+  heap_copy = inline_handle;
+  SMEL_CHECK(!inline_copy.IsInline() && heap_copy.IsInline());
+  SMEL_CHECK(Same(inline_copy, large) && Same(heap_copy, small));
+
+  // Moves, then the moved-from handles are assigned to again
+  AnyExpression<> moved_inline = std::move(heap_copy);
+  AnyExpression<> moved_heap = std::move(inline_copy);
+  SMEL_CHECK(moved_inline.IsInline() && !moved_heap.IsInline());
+  SMEL_CHECK(Same(moved_inline, small) && Same(moved_heap, large));
+  heap_copy = large;
+  inline_copy = std::move(moved_inline);
+  SMEL_CHECK(Same(heap_copy, large) && Same(inline_copy, small));
+  moved_inline = moved_heap;
+  SMEL_CHECK(Same(moved_inline, large));
+
+  // Self-assignment keeps the expression
+  AnyExpression<>& alias = heap_copy;
+  heap_copy = alias;
+  heap_copy = std::move(alias);
+  SMEL_CHECK(Same(heap_copy, large));
+  inline_copy = inline_copy;
+  SMEL_CHECK(Same(inline_copy, small));
+
+  const AnyExpression<> zero;
+  SMEL_CHECK(zero.Evaluate(1.5) == 0.0);
+}
+
+// Handles of both kinds in one vector, moved around by erase and insert
+static void Containers()
+{
+  const Symbol x;
+  const auto large = LargeExpression();
+  std::vector<AnyExpression<>> handles;
+  handles.push_back(sin(x));
+  handles.push_back(large);
+  handles.push_back(x * x);
+  handles.push_back(large * x);
+  handles.push_back(cos(x));
+
+  handles.erase(handles.begin() + 1);
+  handles.insert(handles.begin(), large);
+  handles.insert(handles.begin() + 3, exp(x));
+  handles.erase(handles.begin() + 4);
+  handles[2] = handles[0];
+  handles[0] = std::move(handles[4]);
+  handles.pop_back();
+
+  SMEL_CHECK(handles.size() == 4);
+  SMEL_CHECK(Same(handles[0], cos(x)));
+  SMEL_CHECK(Same(handles[1], sin(x)));
+  SMEL_CHECK(Same(handles[2], large));
+  SMEL_CHECK(Same(handles[3], exp(x)));
+
+  std::vector<AnyExpression<>> copies = handles;
+  handles.clear();
+  SMEL_CHECK(Same(copies[2], large));
+}
+
+static void Batches()
+{
+  const Symbol x;
+  const auto large = LargeExpression();
+  std::vector<double> inputs;
+  for (int i = 0; i < 100; ++i) {
+    inputs.push_back(-2 + 0.04 * i);
+  }
+  std::vector<double> outputs(inputs.size());
+  for (const AnyExpression<>& handle : { AnyExpression<>(sin(x) * x), AnyExpression<>(large) }) {
+    handle.EvaluateBatch(std::span<const double>(inputs), std::span<double>(outputs));
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+      SMEL_CHECK(outputs[i] == handle.Evaluate(inputs[i]));
+    }
+  }
+}
+
+// The first SYMBOLIC_ANY_DERIVATIVE_DEPTH derivatives stay static, the next
+// ones are tapes, all with the values of the static derivatives
+template<typename SymType>
+static void CheckDerivatives(const SymType& expr)
+{
+  const AnyExpression<> handle = expr;
+  const AnyExpression<> d1 = handle.Derivative();
+  const AnyExpression<> d2 = d1.Derivative();
+  const AnyExpression<> d3 = d2.Derivative();
+  SMEL_CHECK(Same(d1, expr.Derivative()));
+  SMEL_CHECK(Same(d2, expr.Derivative().Derivative()));
+  SMEL_CHECK(Same(d3, expr.Derivative().Derivative().Derivative()));
+  SMEL_CHECK(d2.str().rfind("tape(", 0) != 0);
+  SMEL_CHECK(d3.str().rfind("tape(", 0) == 0);
+}
+
+static void Derivatives()
+{
+  const Symbol x;
+  static_assert(SYMBOLIC_ANY_DERIVATIVE_DEPTH == 2);
+  CheckDerivatives(sin(x) * exp(x) / (x * x + Int<1>()));
+  CheckDerivatives(LargeExpression());
+}
+
+
+int main()
+{
+  Storage();
+  Containers();
+  Batches();
+  Derivatives();
+  return check::Result();
+}
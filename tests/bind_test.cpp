@@ -0,0 +1,121 @@
+// Bound: cached subtrees against expr.Evaluate after Reference changes, Stale,
+// Refresh and Rebind, and copies, moves and assignments rebinding
+
+#include <cmath>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "SMEL/Expressions"
+#include "check.hpp"
+
+using namespace SYMBOLIC_NAMESPACE_NAME;
+
+
+// bound against expr at inputs over [0.25, 2]
+template<typename BoundType, typename SymType>
+static bool Same(const BoundType& bound, const SymType& expr)
+{
+  for (int i = 0; i <= 14; ++i) {
+    const double x = 0.25 + 0.125 * i;
+    if (std::abs(bound.Evaluate(x) - expr.Evaluate(x)) > 1e-14 * std::max(1.0, std::abs(expr.Evaluate(x)))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+// ln(k) sqrt(a) does not depend on x and is cached; x parts are not
+static void StaleAndRefresh()
+{
+  const Symbol x;
+  double k = 2.0;
+  double a = 3.0;
+  const auto f = ln(Reference<double>(k)) * sqrt(Reference<double>(a)) * sin(x) + exp(x);
+  auto bound = Bind(f);
+  SMEL_CHECK(bound.size > 0);
+  SMEL_CHECK(!bound.Stale());
+  SMEL_CHECK(Same(bound, f));
+
+  // The cache keeps the old values until refreshed
+  k = 5.0;
+  SMEL_CHECK(bound.Stale());
+  SMEL_CHECK(!Same(bound, f));
+  bound.Refresh();
+  SMEL_CHECK(!bound.Stale());
+  SMEL_CHECK(Same(bound, f));
+
+  // Refresh without a change keeps the cache
+  bound.Refresh();
+  SMEL_CHECK(Same(bound, f));
+
+  // Back to the bound value: no longer stale
+  a = 7.0;
+  SMEL_CHECK(bound.Stale());
+  a = 3.0;
+  SMEL_CHECK(!bound.Stale());
+
+  a = 0.5;
+  bound.Rebind();
+  SMEL_CHECK(!bound.Stale());
+  SMEL_CHECK(Same(bound, f));
+}
+
+// Copies, moves and assignments read the current values, whatever the state
+// of their source
+static void CopiesRebind()
+{
+  const Symbol x;
+  double k = 2.0;
+  const auto f = ln(Reference<double>(k)) * x + RuntimeConstant<double>(1.5) * sqrt(Reference<double>(k));
+  const auto bound = Bind(f);
+
+  k = 4.0;
+  SMEL_CHECK(bound.Stale());
+  auto copy = bound;
+  SMEL_CHECK(!copy.Stale() && Same(copy, f));
+  SMEL_CHECK(bound.Stale());
+
+  k = 6.0;
+  auto moved = std::move(copy);
+  SMEL_CHECK(!moved.Stale() && Same(moved, f));
+
+  k = 8.0;
+  moved = bound;
+  SMEL_CHECK(!moved.Stale() && Same(moved, f));
+  k = 9.0;
+  moved = Bind(f);
+  SMEL_CHECK(!moved.Stale() && Same(moved, f));
+  auto& alias = moved;
+  moved = alias;
+  SMEL_CHECK(Same(moved, f));
+}
+
+// Moves and assignments let a container erase and insert
+static void Containers()
+{
+  const Symbol x;
+  double k = 2.0;
+  const auto f = ln(Reference<double>(k)) * sin(x);
+  std::vector<decltype(Bind(f))> bounds;
+  for (int i = 0; i < 5; ++i) {
+    bounds.push_back(Bind(f));
+  }
+  k = 3.0;
+  bounds.erase(bounds.begin() + 1);
+  bounds.insert(bounds.begin(), Bind(f));
+  SMEL_CHECK(bounds.size() == 5);
+  for (const auto& bound : bounds) {
+    SMEL_CHECK(!bound.Stale() && Same(bound, f));
+  }
+}
+
+
+int main()
+{
+  StaleAndRefresh();
+  CopiesRebind();
+  Containers();
+  return check::Result();
+}
@@ -0,0 +1,60 @@
+#ifndef SMEL_TESTS_CHECK_HPP
+#define SMEL_TESTS_CHECK_HPP
+
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+
+
+// Minimal checks for the test executables: a failed check is reported with its
+// location and the test continues; Result() is the exit code for main
+namespace check {
+
+inline int& Failures()
+{
+  static int failures = 0;
+  return failures;
+}
+
+inline bool That(const bool ok, const char* what, const char* file, const int line)
+{
+  if (!ok) {
+    std::printf("%s:%d: check failed: %s\n", file, line, what);
+    ++Failures();
+  }
+  return ok;
+}
+
+// |actual - expected| within tolerance, relative when |expected| > 1
+inline bool Near(const double actual, const double expected, const double tolerance,
+  const char* what, const char* file, const int line)
+{
+  const double scale = std::max(1.0, std::abs(expected));
+  const bool ok = std::abs(actual - expected) <= tolerance * scale
+    || (std::isinf(actual) && actual == expected);
+  if (!ok) {
+    std::printf("%s:%d: check failed: %s\n  got %.17g, expected %.17g (tolerance %g)\n",
+      file, line, what, actual, expected, tolerance);
+    ++Failures();
+  }
+  return ok;
+}
+
+inline int Result()
+{
+  if (Failures() != 0) {
+    std::printf("%d check(s) failed\n", Failures());
+  }
+  return Failures() == 0 ? 0 : 1;
+}
+
+} // namespace check
+
+
+#define SMEL_CHECK(condition) \
+  ::check::That((condition), #condition, __FILE__, __LINE__)
+
+#define SMEL_CHECK_NEAR(actual, expected, tolerance) \
+  ::check::Near((actual), (expected), (tolerance), #actual " ~ " #expected, __FILE__, __LINE__)
+
+#endif
@@ -0,0 +1,135 @@
+// Cached: values against expr.Evaluate after parameter changes, and which
+// cached subtrees each Evaluate recomputes
+
+#include <span>
+#include <vector>
+
+#include "SMEL/Expressions"
+#include "check.hpp"
+
+using namespace SYMBOLIC_NAMESPACE_NAME;
+
+
+template<typename SymType, typename T>
+static void CheckValues(const SymType& expr, Cached<SymType,T>& cached)
+{
+  const std::vector<T>& values = cached.Evaluate();
+  const std::vector<T>& inputs = cached.Inputs();
+  SMEL_CHECK(values.size() == inputs.size());
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    SMEL_CHECK_NEAR(values[i], expr.Evaluate(inputs[i]), 1e-14);
+  }
+}
+
+static std::vector<double> Inputs()
+{
+  std::vector<double> inputs;
+  for (int i = 0; i <= 50; ++i) {
+    inputs.push_back(-2 + 0.08 * i);
+  }
+  return inputs;
+}
+
+
+// sin(p x) + exp(q x): a change of p recomputes the sum, sin, p x and p, and
+// leaves the exp subtree and x alone
+static void OneParameterChanged()
+{
+  const Symbol x;
+  double p = 1.5;
+  double q = 0.5;
+  const auto f = sin(Reference<double>(p) * x) + exp(Reference<double>(q) * x);
+  const std::vector<double> inputs = Inputs();
+  auto cached = Cache(f, std::span<const double>(inputs));
+  SMEL_CHECK(cached.Parameters() == 2);
+
+  CheckValues(f, cached);
+  SMEL_CHECK(cached.Recomputed() == cached.units);
+
+  // Nothing changed: nothing is recomputed and the values stay
+  CheckValues(f, cached);
+  SMEL_CHECK(cached.Recomputed() == 0);
+
+  p = -0.75;
+  CheckValues(f, cached);
+  SMEL_CHECK(cached.Recomputed() == 4);
+  q = 2.0;
+  CheckValues(f, cached);
+  SMEL_CHECK(cached.Recomputed() == 4);
+
+  // Both at once: the union of both paths, the sum counted once
+  p = 0.25;
+  q = -1.0;
+  CheckValues(f, cached);
+  SMEL_CHECK(cached.Recomputed() == 7);
+
+  // Writing the same value again is no change
+  p = 0.25;
+  CheckValues(f, cached);
+  SMEL_CHECK(cached.Recomputed() == 0);
+}
+
+static void Invalidate()
+{
+  const Symbol x;
+  double p = 1.5;
+  const auto f = sin(Reference<double>(p) * x) + x * x;
+  const std::vector<double> inputs = Inputs();
+  auto cached = Cache(f, std::span<const double>(inputs));
+  CheckValues(f, cached);
+
+  cached.Invalidate();
+  CheckValues(f, cached);
+  SMEL_CHECK(cached.Recomputed() == cached.units);
+  CheckValues(f, cached);
+  SMEL_CHECK(cached.Recomputed() == 0);
+}
+
+// p appears under two subtrees: one parameter, and a change recomputes both
+// paths but not the subtree of q
+static void SharedParameter()
+{
+  const Symbol x;
+  double p = 1.5;
+  double q = 0.5;
+  const Reference<double> rp(p);
+  const auto f = sin(rp * x) * cos(rp + x) + exp(Reference<double>(q) * x) + x * x;
+  const std::vector<double> inputs = Inputs();
+  auto cached = Cache(f, std::span<const double>(inputs));
+  SMEL_CHECK(cached.Parameters() == 2);
+  CheckValues(f, cached);
+
+  // the sum, the product, sin, p x, p, cos, p + x and p again
+  p = 3.0;
+  CheckValues(f, cached);
+  SMEL_CHECK(cached.Recomputed() == 8);
+  SMEL_CHECK(cached.Recomputed() < cached.units);
+
+  q = -0.5;
+  CheckValues(f, cached);
+  SMEL_CHECK(cached.Recomputed() == 4);
+}
+
+// Parameter-free expressions are one unit, computed once
+static void NoParameters()
+{
+  const Symbol x;
+  const auto f = sin(x) * exp(x);
+  const std::vector<double> inputs = Inputs();
+  auto cached = Cache(f, std::span<const double>(inputs));
+  SMEL_CHECK(cached.units == 1 && cached.Parameters() == 0);
+  CheckValues(f, cached);
+  SMEL_CHECK(cached.Recomputed() == 1);
+  CheckValues(f, cached);
+  SMEL_CHECK(cached.Recomputed() == 0);
+}
+
+
+int main()
+{
+  OneParameterChanged();
+  Invalidate();
+  SharedParameter();
+  NoParameters();
+  return check::Result();
+}
@@ -0,0 +1,107 @@
+// EvaluateRange must enclose every value the expression takes on the interval:
+// checked against dense point samples, around the cases that need care
+
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+#include "SMEL/Expressions"
+#include "check.hpp"
+
+using namespace SYMBOLIC_NAMESPACE_NAME;
+
+constexpr double pi = std::numbers::pi;
+constexpr double inf = std::numeric_limits<double>::infinity();
+
+
+// Every finite value of expr at 4001 points of [lo, hi], both ends included,
+// lies in EvaluateRange(expr, lo, hi). Returns the enclosure.
+template<typename SymType, typename T>
+static Interval<T> CheckEncloses(const SymType& expr, const T lo, const T hi, const char* name)
+{
+  const Interval<T> range = EvaluateRange(expr, lo, hi);
+  const int n = 4000;
+  for (int i = 0; i <= n; ++i) {
+    const T x = (i == n) ? hi : lo + (hi - lo) * static_cast<T>(i) / static_cast<T>(n);
+    const T value = expr.Evaluate(x);
+    if (std::isfinite(value) && !range.Contains(value)) {
+      check::That(false, name, __FILE__, __LINE__);
+      return range;
+    }
+  }
+  return range;
+}
+
+
+// Extrema strictly inside the interval are not at its ends
+static void SinCosExtrema()
+{
+  const Symbol x;
+  const auto sin_max = CheckEncloses(sin(x), 0.5, 2.5, "sin over [0.5, 2.5]");
+  SMEL_CHECK(sin_max.Upper() == 1.0);
+  const auto sin_min = CheckEncloses(sin(x), -2.0, -1.0, "sin over [-2, -1]");
+  SMEL_CHECK(sin_min.Lower() == -1.0);
+  const auto cos_both = CheckEncloses(cos(x), -1.0, 4.0, "cos over [-1, 4]");
+  SMEL_CHECK(cos_both.Lower() == -1.0 && cos_both.Upper() == 1.0);
+
+  // Monotonic pieces stay tight
+  const auto cos_narrow = CheckEncloses(cos(x), 0.1, 0.2, "cos over [0.1, 0.2]");
+  SMEL_CHECK(cos_narrow.Upper() < 1.0 && cos_narrow.Width() < 0.03);
+
+  // Extrema at the ends: at pi/2 itself, and over a whole period
+  CheckEncloses(sin(x), pi / 2, 3.0, "sin over [pi/2, 3]");
+  const auto period = CheckEncloses(sin(x), -10.0, 10.0, "sin over [-10, 10]");
+  SMEL_CHECK(period.Lower() == -1.0 && period.Upper() == 1.0);
+
+  CheckEncloses(sin(x) * x + exp(x) * cos(x), -3.0, 3.0, "x sin x + e^x cos x");
+  CheckEncloses((sin(x) * x + exp(x) * cos(x)).Derivative(), -3.0, 3.0, "(x sin x + e^x cos x)'");
+  CheckEncloses(sin(x), 0.5f, 2.5f, "sin over [0.5, 2.5] in float");
+}
+
+// A denominator that spans zero makes the quotient unbounded on that side
+static void DenominatorSpanningZero()
+{
+  const Symbol x;
+  const auto both = CheckEncloses(Int<1>() / x, -1.0, 1.0, "1/x over [-1, 1]");
+  SMEL_CHECK(both.Lower() == -inf && both.Upper() == inf);
+  const auto shifted = CheckEncloses(Int<1>() / (x - Int<1>()), 0.0, 3.0, "1/(x-1) over [0, 3]");
+  SMEL_CHECK(shifted.Lower() == -inf && shifted.Upper() == inf);
+  const auto upper = CheckEncloses(Int<1>() / x, 0.0, 2.0, "1/x over [0, 2]");
+  SMEL_CHECK(upper.Lower() <= 0.5 && upper.Upper() == inf);
+  CheckEncloses(sin(x) / x, -1.0, 1.0, "sin x / x over [-1, 1]");
+  CheckEncloses(sin(x) / (x + Int<2>()), -1.0, 1.0, "sin x / (x+2) over [-1, 1]");
+}
+
+// tan is unbounded across the pole at pi/2, tight between poles
+static void TanAcrossPole()
+{
+  const Symbol x;
+  const auto pole = CheckEncloses(tan(x), 1.0, 2.0, "tan over [1, 2]");
+  SMEL_CHECK(pole.Lower() == -inf && pole.Upper() == inf);
+  const auto negative_pole = CheckEncloses(tan(x), -2.0, -1.0, "tan over [-2, -1]");
+  SMEL_CHECK(negative_pole.Lower() == -inf && negative_pole.Upper() == inf);
+  const auto between = CheckEncloses(tan(x), -1.0, 1.0, "tan over [-1, 1]");
+  SMEL_CHECK(std::isfinite(between.Lower()) && std::isfinite(between.Upper()));
+  CheckEncloses(sec(x), -1.0, 1.0, "sec over [-1, 1]");
+}
+
+// Points below zero are outside the domain and dropped
+static void SqrtOfNegativeLowerBound()
+{
+  const Symbol x;
+  const auto root = CheckEncloses(sqrt(x), -1.0, 4.0, "sqrt over [-1, 4]");
+  SMEL_CHECK(root.Lower() == 0.0 && root.Upper() >= 2.0 && root.Upper() < 2.0 + 1e-12);
+  CheckEncloses(sqrt(x - Int<1>()), 0.0, 2.0, "sqrt(x-1) over [0, 2]");
+  CheckEncloses(pow<3>(x) - x * x + sqrt(x), -0.5, 2.0, "x^3 - x^2 + sqrt x over [-0.5, 2]");
+  CheckEncloses(ln(x), -1.0, 3.0, "ln over [-1, 3]");
+}
+
+
+int main()
+{
+  SinCosExtrema();
+  DenominatorSpanningZero();
+  TanAcrossPole();
+  SqrtOfNegativeLowerBound();
+  return check::Result();
+}
@@ -0,0 +1,33 @@
+// Compile-only regression checks on the size of expression objects, kept out of
+// the headers so that user code does not build these trees. Stateless children
+// are not stored (see Branch), so a fully static tree and all of its
+// derivatives take a single byte, and dynamic trees only pay for their runtime
+// data.
+
+#include <utility>
+
+#include "SMEL/Expressions"
+
+using namespace SYMBOLIC_NAMESPACE_NAME;
+
+
+using Poly = decltype(sin(Symbol()) * Symbol() + pow<3>(Symbol()) + ln(Symbol()) + exp(Symbol()));
+using PolyPrime = decltype(std::declval<Poly>().Derivative());
+using PolyPrime2 = decltype(std::declval<PolyPrime>().Derivative());
+using Ratio = decltype(Symbol() / (Symbol() + Int<1>()));
+using RatioPrime = decltype(std::declval<Ratio>().Derivative());
+using TanPrime2 = decltype(tan(Symbol()).Derivative().Derivative());
+
+static_assert(sizeof(Poly) == 1);
+static_assert(sizeof(PolyPrime) == 1);
+static_assert(sizeof(PolyPrime2) == 1);
+static_assert(sizeof(Ratio) == 1);
+static_assert(sizeof(RatioPrime) == 1);
+static_assert(sizeof(TanPrime2) == 1);
+
+using Scaled = decltype(sin(RuntimeConstant<double>(1) * Symbol()));
+using Referenced = decltype(Reference<double>(std::declval<const double&>()) * exp(Symbol()));
+
+static_assert(sizeof(Scaled) == sizeof(double));
+static_assert(sizeof(decltype(std::declval<Scaled>().Derivative())) == 2 * sizeof(double));
+static_assert(sizeof(Referenced) == sizeof(const double*));
@@ -0,0 +1,78 @@
+// Cheapest() must only pick forms equal to the expression it was given. Each
+// rewrite is checked to fire and to agree with the original at sampled inputs.
+
+#include <cmath>
+#include <type_traits>
+
+#include "SMEL/Expressions"
+#include "check.hpp"
+
+using namespace SYMBOLIC_NAMESPACE_NAME;
+
+
+// Cheapest(expr) against expr at inputs over [-2, 2], 0 and the integers
+// included. Inputs where expr itself is not finite are skipped: rewriting may
+// remove a removable singularity, as in x * (1/x + 1).
+template<typename SymType>
+static void CheckEquivalent(const SymType& expr, const char* name)
+{
+  const auto cheapest = Cheapest(expr);
+  check::That(!std::is_same_v<std::decay_t<decltype(cheapest)>, SymType>, name, __FILE__, __LINE__);
+  check::That(EvalCost(cheapest) < EvalCost(expr), name, __FILE__, __LINE__);
+  for (int i = 0; i <= 32; ++i) {
+    const double x = -2 + 0.125 * i;
+    const double expected = expr.Evaluate(x);
+    if (std::isfinite(expected)) {
+      check::Near(cheapest.Evaluate(x), expected, 1e-12, name, __FILE__, __LINE__);
+    }
+  }
+}
+
+
+static void Factoring()
+{
+  const Symbol x;
+  CheckEquivalent(x + (x^Int<2>()) + (x^Int<3>()), "factoring: x + x^2 + x^3");
+  CheckEquivalent(x * exp(x) + x * x, "factoring: x e^x + x^2");
+
+  // The common factor is 0 there: factoring must not divide by it
+  SMEL_CHECK(Cheapest(x + (x^Int<2>()) + (x^Int<3>())).Evaluate(0.0) == 0.0);
+  SMEL_CHECK(Cheapest(x * exp(x) + x * x).Evaluate(0.0) == 0.0);
+}
+
+static void Distribution()
+{
+  const Symbol x;
+  CheckEquivalent(x * (Int<1>() / x + sin(x)), "distribution: x (1/x + sin x)");
+  CheckEquivalent(exp(x) * (exp(-x) + x), "distribution: e^x (e^-x + x)");
+  CheckEquivalent((x^Int<2>()) * ((x^Int<-1>()) + Int<3>()), "distribution: x^2 (x^-1 + 3)");
+}
+
+static void CommonDenominator()
+{
+  const Symbol x;
+  CheckEquivalent(sin(x) / x + cos(x) / x, "common denominator: sin x / x + cos x / x");
+  CheckEquivalent(Int<1>() / (x + Int<1>()) + Int<1>() / (x + Int<2>()),
+    "common denominator: 1/(x+1) + 1/(x+2)");
+  CheckEquivalent(Int<1>() / x + sin(x) / x + cos(x) / (x + Int<1>()),
+    "common denominator: 1/x + sin x / x + cos x / (x+1)");
+}
+
+static void PowerExpansion()
+{
+  const Symbol x;
+  CheckEquivalent((x^Int<3>()) * exp(x), "power expansion: x^3 e^x");
+  CheckEquivalent((x^Int<-2>()) + sin(x), "power expansion: x^-2 + sin x");
+  CheckEquivalent((pow<5>(x) + Int<3>() * pow<3>(x) + x).Derivative(), "power expansion: (x^5 + 3x^3 + x)'");
+  CheckEquivalent((sin(x) / (x + Int<1>())).Derivative().Derivative(), "power expansion: (sin x / (x+1))''");
+}
+
+
+int main()
+{
+  Factoring();
+  Distribution();
+  CommonDenominator();
+  PowerExpansion();
+  return check::Result();
+}
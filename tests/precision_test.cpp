@@ -0,0 +1,132 @@
+// Approximate elementary functions: the maximum relative errors of the table
+// in precision.hpp for every tier, in double and in float, and the documented
+// handling of NaN, infinities and huge arguments
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include "SMEL/Expressions"
+#include "check.hpp"
+
+using namespace SYMBOLIC_NAMESPACE_NAME;
+
+constexpr double quiet_nan = std::numeric_limits<double>::quiet_NaN();
+constexpr double infinity = std::numeric_limits<double>::infinity();
+
+
+// Largest relative error of approximate against the double reference at 20001
+// points of [lo, hi], in T; logarithmic spacing when log_spaced
+template<typename T, typename Approximation, typename Reference>
+static double MaxRelativeError(const Approximation& approximate, const Reference& reference,
+  const double lo, const double hi, const bool log_spaced = false)
+{
+  const int n = 20000;
+  double worst = 0;
+  for (int i = 0; i <= n; ++i) {
+    const double s = static_cast<double>(i) / n;
+    const T x = static_cast<T>(log_spaced ? lo * std::pow(hi / lo, s) : lo + (hi - lo) * s);
+    const double expected = reference(static_cast<double>(x));
+    const double value = static_cast<double>(approximate(x));
+    const double error = (value == expected) ? 0 : std::abs(value - expected) / std::abs(expected);
+    worst = std::max(worst, std::isnan(error) ? infinity : error);
+  }
+  return worst;
+}
+
+// One row of the table for Policy in T: exp, log, sin/cos, tan, atan/asin/acos
+template<typename Policy, typename T>
+static void CheckBounds(const char* tier, const double exp_bound, const double log_bound,
+  const double sin_bound, const double tan_bound, const double atan_bound)
+{
+  const auto check_bound = [&](const char* function, const double error, const double bound) {
+    const std::string what = std::string(tier) + " " + function + (sizeof(T) == 4 ? " in float" : " in double");
+    if (!check::That(error <= bound, what.c_str(), __FILE__, __LINE__)) {
+      std::printf("  relative error %.3g, bound %.3g\n", error, bound);
+    }
+  };
+
+  check_bound("exp", MaxRelativeError<T>([](T x) { return ApproximateExp<Policy>(x); },
+    [](double x) { return std::exp(x); }, -80, 80), exp_bound);
+  check_bound("log", MaxRelativeError<T>([](T x) { return ApproximateLog<Policy>(x); },
+    [](double x) { return std::log(x); }, 1e-30, 1e30, true), log_bound);
+  check_bound("log near 1", MaxRelativeError<T>([](T x) { return ApproximateLog<Policy>(x); },
+    [](double x) { return std::log(x); }, 0.5, 2), log_bound);
+  check_bound("sin", MaxRelativeError<T>([](T x) { return ApproximateSin<Policy>(x); },
+    [](double x) { return std::sin(x); }, -100, 100), sin_bound);
+  check_bound("cos", MaxRelativeError<T>([](T x) { return ApproximateCos<Policy>(x); },
+    [](double x) { return std::cos(x); }, -100, 100), sin_bound);
+  check_bound("tan", MaxRelativeError<T>([](T x) { return ApproximateTan<Policy>(x); },
+    [](double x) { return std::tan(x); }, -100, 100), tan_bound);
+  check_bound("atan", MaxRelativeError<T>([](T x) { return ApproximateAtan<Policy>(x); },
+    [](double x) { return std::atan(x); }, -1e3, 1e3), atan_bound);
+  check_bound("asin", MaxRelativeError<T>([](T x) { return ApproximateAsin<Policy>(x); },
+    [](double x) { return std::asin(x); }, -0.999, 0.999), atan_bound);
+  check_bound("acos", MaxRelativeError<T>([](T x) { return ApproximateAcos<Policy>(x); },
+    [](double x) { return std::acos(x); }, -0.999, 0.999), atan_bound);
+}
+
+
+static void Bounds()
+{
+  CheckBounds<Fast, double>("Fast", 8e-8, 1.2e-7, 4e-8, 3e-8, 2e-8);
+  CheckBounds<Faster, double>("Faster", 8e-5, 2.3e-5, 1.2e-5, 1.1e-5, 1.9e-5);
+  CheckBounds<Fast, float>("Fast", 4e-7, 4e-7, 4e-7, 4e-7, 4e-7);
+  CheckBounds<Faster, float>("Faster", 8e-5, 2.3e-5, 1.2e-5, 1.1e-5, 1.9e-5);
+}
+
+// Integer exponents up to 64 multiply exactly up to rounding
+static void IntegerPowers()
+{
+  for (const double x : { 0.3, 1.1, -2.5 }) {
+    for (const int n : { -64, -7, -1, 0, 1, 2, 13, 64 }) {
+      const double expected = std::pow(x, n);
+      SMEL_CHECK(std::abs(ApproximatePow<Faster>(x, static_cast<double>(n)) - expected) <= 1e-13 * std::abs(expected));
+    }
+  }
+}
+
+// NaN gives NaN in exp, sin, cos and tan; infinities give NaN in sin, cos and
+// tan; exp saturates near 2^-1022 and 2^1023 (2^-126 and 2^127 in float)
+template<typename Policy, typename T>
+static void Edges()
+{
+  const T t_nan = static_cast<T>(quiet_nan);
+  const T t_inf = static_cast<T>(infinity);
+  SMEL_CHECK(std::isnan(ApproximateExp<Policy>(t_nan)));
+  SMEL_CHECK(std::isnan(ApproximateSin<Policy>(t_nan)));
+  SMEL_CHECK(std::isnan(ApproximateCos<Policy>(t_nan)));
+  SMEL_CHECK(std::isnan(ApproximateTan<Policy>(t_nan)));
+  for (const T x : { t_inf, -t_inf }) {
+    SMEL_CHECK(std::isnan(ApproximateSin<Policy>(x)));
+    SMEL_CHECK(std::isnan(ApproximateCos<Policy>(x)));
+    SMEL_CHECK(std::isnan(ApproximateTan<Policy>(x)));
+  }
+
+  constexpr int max_exponent = std::numeric_limits<T>::max_exponent;
+  const T high = ApproximateExp<Policy>(t_inf);
+  const T low = ApproximateExp<Policy>(-t_inf);
+  SMEL_CHECK(std::isfinite(high) && std::ilogb(high) >= max_exponent - 2);
+  SMEL_CHECK(low > 0 && std::ilogb(low) >= 1 - max_exponent && std::ilogb(low) <= 2 - max_exponent);
+  SMEL_CHECK(ApproximateExp<Policy>(std::numeric_limits<T>::max()) == high);
+  SMEL_CHECK(ApproximateExp<Policy>(std::numeric_limits<T>::lowest()) == low);
+
+  // Beyond the accurate range sin, cos and tan still return, NaN or otherwise
+  for (const T x : { static_cast<T>(1e20), static_cast<T>(-1e30), std::numeric_limits<T>::max() }) {
+    ApproximateSin<Policy>(x);
+    ApproximateCos<Policy>(x);
+    ApproximateTan<Policy>(x);
+  }
+}
+
+
+int main()
+{
+  Bounds();
+  IntegerPowers();
+  Edges<Fast, double>();
+  Edges<Faster, double>();
+  Edges<Fast, float>();
+  Edges<Faster, float>();
+  return check::Result();
+}
@@ -0,0 +1,117 @@
+// Integrate: known integrals with both rules, interval orientation, and the
+// converged flag of IntegrateWithError
+
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include "SMEL/Expressions"
+#include "check.hpp"
+
+using namespace SYMBOLIC_NAMESPACE_NAME;
+
+constexpr double pi = std::numbers::pi;
+
+
+template<QuadratureRule Rule>
+static void KnownIntegrals()
+{
+  const Symbol x;
+  SMEL_CHECK_NEAR(Integrate<Rule>(sin(x), 0.0, pi, 1e-12), 2.0, 1e-12);
+  SMEL_CHECK_NEAR(Integrate<Rule>(exp(x), -1.0, 1.0, 1e-12), std::exp(1.0) - std::exp(-1.0), 1e-12);
+  SMEL_CHECK_NEAR(Integrate<Rule>(x * x, 0.0, 3.0, 1e-12), 9.0, 1e-12);
+
+  const auto result = IntegrateWithError<Rule>(cos(x), 0.0, pi / 2, 1e-10);
+  SMEL_CHECK(result.converged);
+  SMEL_CHECK(result.error <= 1e-10);
+  SMEL_CHECK_NEAR(result.value, 1.0, 1e-10);
+}
+
+// Reversing the bounds negates the integral; an empty interval integrates to 0
+template<QuadratureRule Rule>
+static void Orientation()
+{
+  const Symbol x;
+  SMEL_CHECK_NEAR(Integrate<Rule>(sin(x), pi, 0.0, 1e-12), -2.0, 1e-12);
+  SMEL_CHECK_NEAR(Integrate<Rule>(exp(x), 1.0, -1.0, 1e-12), std::exp(-1.0) - std::exp(1.0), 1e-12);
+
+  const auto empty = IntegrateWithError<Rule>(sin(x), 1.5, 1.5, 1e-12);
+  SMEL_CHECK(empty.value == 0.0);
+  SMEL_CHECK(empty.converged);
+}
+
+// Endpoint singularities are what tanh-sinh is for: its nodes never reach the
+// endpoints and crowd towards them
+static void EndpointSingularities()
+{
+  const Symbol x;
+  SMEL_CHECK_NEAR(Integrate<QuadratureRule::TanhSinh>(One<>() / sqrt(x), 0.0, 1.0, 1e-10), 2.0, 1e-10);
+  SMEL_CHECK_NEAR(Integrate<QuadratureRule::TanhSinh>(ln(x), 0.0, 1.0, 1e-10), -1.0, 1e-10);
+  SMEL_CHECK_NEAR(Integrate<QuadratureRule::TanhSinh>(One<>() / sqrt(x), 1.0, 0.0, 1e-10), -2.0, 1e-10);
+}
+
+// 1/x over [-1, 2] diverges and sqrt or ln of negative numbers is NaN: the
+// result must say so instead of passing off whatever value the panels sum to
+static void NotConverged()
+{
+  const Symbol x;
+  const auto divergent = IntegrateWithError(One<>() / x, -1.0, 2.0, 1e-12);
+  SMEL_CHECK(!divergent.converged);
+
+  // NaN everywhere: outside the domain of sqrt and ln
+  const auto gk_sqrt = IntegrateWithError(sqrt(x), -2.0, -1.0, 1e-10);
+  SMEL_CHECK(!gk_sqrt.converged && std::isnan(gk_sqrt.value));
+  const auto ts_sqrt = IntegrateWithError<QuadratureRule::TanhSinh>(sqrt(x), -2.0, -1.0, 1e-10);
+  SMEL_CHECK(!ts_sqrt.converged && std::isnan(ts_sqrt.value));
+  const auto ts_ln = IntegrateWithError<QuadratureRule::TanhSinh>(ln(x), -1.0, 1.0, 1e-10);
+  SMEL_CHECK(!ts_ln.converged && std::isnan(ts_ln.value));
+
+  // A pole inside the interval, hit exactly by the central node
+  const auto ts_pole = IntegrateWithError<QuadratureRule::TanhSinh>(One<>() / x, -1.0, 1.0, 1e-10);
+  SMEL_CHECK(!ts_pole.converged);
+
+  const auto starved = IntegrateWithError(sin(Int<50>() * x), 0.0, 10.0, 1e-14, 2);
+  SMEL_CHECK(!starved.converged);
+  SMEL_CHECK(starved.error > 1e-14);
+}
+
+static void Batches()
+{
+  const Symbol x;
+  const std::vector<double> a = { 0.0, 0.0, pi, -1.0 };
+  const std::vector<double> b = { pi, pi / 2, 0.0, 1.0 };
+  std::vector<QuadratureResult<double>> out(4);
+  Integrate(sin(x), a, b, out, 1e-12);
+  SMEL_CHECK_NEAR(out[0].value, 2.0, 1e-12);
+  SMEL_CHECK_NEAR(out[1].value, 1.0, 1e-12);
+  SMEL_CHECK_NEAR(out[2].value, -2.0, 1e-12);
+  SMEL_CHECK(out[0].converged && out[1].converged && out[2].converged);
+  // The pole at 2 lies in the first and third intervals only
+  Integrate(One<>() / (x - Int<2>()), a, b, out, 1e-12);
+  SMEL_CHECK(!out[0].converged && out[1].converged && !out[2].converged && out[3].converged);
+
+  const auto each = IntegrateEach(0.0, pi, 1e-12, sin(x), cos(x), One<>() / (x - Int<1>()));
+  SMEL_CHECK_NEAR(each[0].value, 2.0, 1e-12);
+  SMEL_CHECK_NEAR(each[1].value, 0.0, 1e-12);
+  SMEL_CHECK(each[0].converged && each[1].converged && !each[2].converged);
+  SMEL_CHECK(each[0].error <= 1e-12);
+
+  const auto parallel = IntegrateParallel(exp(x), -1.0, 1.0, 1e-12, 3);
+  SMEL_CHECK_NEAR(parallel.value, std::exp(1.0) - std::exp(-1.0), 1e-12);
+  SMEL_CHECK(parallel.converged && parallel.error <= 1e-12);
+  // Only the middle one of three subintervals contains the pole
+  SMEL_CHECK(!IntegrateParallel(One<>() / x, -1.0, 2.0, 1e-12, 3).converged);
+  SMEL_CHECK(IntegrateParallel(One<>() / x, 1.0, 2.0, 1e-12, 3).converged);
+}
+
+int main()
+{
+  KnownIntegrals<QuadratureRule::GaussKronrod>();
+  KnownIntegrals<QuadratureRule::TanhSinh>();
+  Orientation<QuadratureRule::GaussKronrod>();
+  Orientation<QuadratureRule::TanhSinh>();
+  EndpointSingularities();
+  NotConverged();
+  Batches();
+  return check::Result();
+}
@@ -0,0 +1,38 @@
+// Cancellation of common factors and flattening of nested quotients
+
+#include <cmath>
+#include <numbers>
+
+#include "SMEL/Expressions"
+#include "check.hpp"
+
+using namespace SYMBOLIC_NAMESPACE_NAME;
+
+
+static void Cancellation()
+{
+  const Symbol x;
+  SMEL_CHECK_NEAR(((x^Int<2>()) / (x^Int<3>())).Evaluate(4.0), 0.25, 1e-15);
+  SMEL_CHECK_NEAR(((Int<6>() * x) / Int<2>()).Evaluate(3.0), 9.0, 1e-15);
+  SMEL_CHECK_NEAR(((sin(x) * x) / (x * cos(x))).Evaluate(0.5), std::tan(0.5), 1e-15);
+  SMEL_CHECK_NEAR(((x / sin(x)) / (x / cos(x))).Evaluate(0.5), 1 / std::tan(0.5), 1e-15);
+}
+
+// A static coefficient in the denominator only cancels against one in the
+// numerator, not against the base of a power: these used to recurse without end
+static void CoefficientAgainstPowerBase()
+{
+  const Symbol x;
+  SMEL_CHECK_NEAR((exp(x) / constant_e<>()).Evaluate(1.0), 1.0, 1e-15);
+  SMEL_CHECK_NEAR((exp(x) / constant_e<>()).Evaluate(2.5), std::exp(1.5), 1e-14);
+  SMEL_CHECK_NEAR(((Int<2>()^x) / Int<2>()).Evaluate(3.0), 4.0, 1e-15);
+  SMEL_CHECK_NEAR(Cheapest(Int<2>() * x + (Int<2>()^x)).Evaluate(3.0), 14.0, 1e-15);
+}
+
+
+int main()
+{
+  Cancellation();
+  CoefficientAgainstPowerBase();
+  return check::Result();
+}
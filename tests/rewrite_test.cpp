@@ -0,0 +1,62 @@
+// Construction rules rooted at sums, products and quotients apply while the
+// expression is built, like those rooted at functions. The rule set is named
+// before the library is included and defined once its node types exist.
+
+namespace Smel { struct TestRules; }
+#define SYMBOLIC_CONSTRUCTION_RULES TestRules
+
+#include <cmath>
+
+#include "SMEL/Expressions"
+#include "check.hpp"
+
+using namespace SYMBOLIC_NAMESPACE_NAME;
+
+typedef Wildcard<0> A;
+typedef Wildcard<1> B;
+
+// Patterns of sums and products are written in their canonical order
+struct SYMBOLIC_NAMESPACE_NAME::TestRules : rule_set_cat_t<ExpLogRules, RuleSet<
+    Rule< Quotient<Sine<A>, Cosine<A>>, Tangent<A> >,
+    Rule< TupleProduct<Cosine<A>, Secant<A>>, One<> >,
+    Rule< TupleSum<Logarithm<constant_e<>, A>, Logarithm<constant_e<>, B>>,
+          Logarithm<constant_e<>, TupleProduct<A, B>> >
+  >>
+{};
+
+
+static void FunctionRoots()
+{
+  const Symbol x;
+  SMEL_CHECK((std::is_same_v<decltype(exp(ln(x))), Symbol>));
+  SMEL_CHECK((std::is_same_v<decltype(ln(exp(sin(x)))), Sine<Symbol>>));
+}
+
+static void ArithmeticRoots()
+{
+  const Symbol x;
+  SMEL_CHECK((std::is_same_v<decltype(sin(x) / cos(x)), Tangent<Symbol>>));
+  SMEL_CHECK((std::is_same_v<decltype(cos(x) * sec(x)), One<>>));
+  SMEL_CHECK((std::is_same_v<decltype(sec(x) * cos(x)), One<>>));
+
+  const auto logs = ln(x) + ln(sin(x));
+  SMEL_CHECK(node_kind_v<std::decay_t<decltype(logs)>> == NodeKind::Logarithm);
+  SMEL_CHECK_NEAR(logs.Evaluate(0.7), std::log(0.7) + std::log(std::sin(0.7)), 1e-15);
+
+  // Rules also apply to the nodes built inside a larger expression...
+  const auto inner = Int<2>() * (sin(x) / cos(x)) + x;
+  SMEL_CHECK_NEAR(inner.Evaluate(0.4), 2 * std::tan(0.4) + 0.4, 1e-15);
+  SMEL_CHECK(inner.str().find("tan") != std::string::npos);
+
+  // ...and to those built while taking derivatives
+  const auto derivative = (ln(sin(x)) * x).Derivative();
+  SMEL_CHECK_NEAR(derivative.Evaluate(0.6), std::log(std::sin(0.6)) + 0.6 / std::tan(0.6), 1e-14);
+}
+
+
+int main()
+{
+  FunctionRoots();
+  ArithmeticRoots();
+  return check::Result();
+}
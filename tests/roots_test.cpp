@@ -0,0 +1,78 @@
+// SolveRoots: residuals of converged problems, failure reporting, and the
+// bisection fallback when Newton steps diverge
+
+#include <cmath>
+#include <vector>
+
+#include "SMEL/Expressions"
+#include "check.hpp"
+
+using namespace SYMBOLIC_NAMESPACE_NAME;
+
+
+// Targets over [-50, 50], some started far from their root, a count that
+// leaves a partial block
+template<RootMethod Method>
+static void Residuals()
+{
+  const Symbol x;
+  const auto f = pow<3>(x) + sin(x) + x;
+  const std::size_t n = 1003;
+  std::vector<double> targets(n), guesses(n), roots(n);
+  std::vector<int> iterations(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    targets[i] = 0.1 * static_cast<double>(i) - 50;
+    guesses[i] = (i % 7 == 0) ? 100.0 : 0.5;
+  }
+
+  SMEL_CHECK(SolveRoots<Method>(f, targets, guesses, roots, 1e-12, iterations) == n);
+  for (std::size_t i = 0; i < n; ++i) {
+    SMEL_CHECK_NEAR(f.Evaluate(roots[i]), targets[i], 1e-12);
+    SMEL_CHECK(iterations[i] > 0 && iterations[i] <= 64);
+  }
+}
+
+// x^2 = -1 has no real root: the problem reports -1 iterations and does not
+// count as converged, while its neighbours in the block still do
+static void NoRoot()
+{
+  const Symbol x;
+  const std::vector<double> targets = { 4.0, -1.0, 9.0 };
+  const std::vector<double> guesses = { 1.0, 1.0, 1.0 };
+  std::vector<double> roots(3);
+  std::vector<int> iterations(3);
+
+  SMEL_CHECK(SolveRoots(x * x, targets, guesses, roots, 1e-12, iterations) == 2);
+  SMEL_CHECK(iterations[1] == -1);
+  SMEL_CHECK(iterations[0] > 0 && iterations[2] > 0);
+  SMEL_CHECK_NEAR(roots[0], 2.0, 1e-12);
+  SMEL_CHECK_NEAR(roots[2], 3.0, 1e-12);
+}
+
+// Newton on arctan(x) = 0 diverges from any |x| > 1.39: from 3 the solver only
+// reaches 0 through damped steps and bisection of the bracket it finds
+template<RootMethod Method>
+static void BisectionFallback()
+{
+  const Symbol x;
+  const std::vector<double> targets = { 0.0, 0.0 };
+  const std::vector<double> guesses = { 3.0, -10.0 };
+  std::vector<double> roots(2);
+  std::vector<int> iterations(2);
+
+  SMEL_CHECK(SolveRoots<Method>(arctan(x), targets, guesses, roots, 1e-12, iterations) == 2);
+  SMEL_CHECK_NEAR(roots[0], 0.0, 1e-12);
+  SMEL_CHECK_NEAR(roots[1], 0.0, 1e-12);
+  SMEL_CHECK(iterations[0] > 0 && iterations[1] > 0);
+}
+
+
+int main()
+{
+  Residuals<RootMethod::Newton>();
+  Residuals<RootMethod::Halley>();
+  NoRoot();
+  BisectionFallback<RootMethod::Newton>();
+  BisectionFallback<RootMethod::Halley>();
+  return check::Result();
+}
@@ -0,0 +1,202 @@
+// Tapes against the static expressions they were built from: values and 1st to
+// 3rd derivatives for every tape instruction, constant exponents of any value,
+// and Reference parameters changed after the tapes were built
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "SMEL/Expressions"
+#include "check.hpp"
+
+using namespace SYMBOLIC_NAMESPACE_NAME;
+
+constexpr std::size_t op_count = static_cast<std::size_t>(TapeOp::Sign) + 1;
+static bool seen[op_count] = {};
+
+
+template<typename T>
+static void MarkOps(const Tape<T>& tape)
+{
+  for (const TapeInstruction& ins : tape.Instructions()) {
+    seen[static_cast<std::size_t>(ins.op)] = true;
+  }
+}
+
+// tape against expr at inputs spread over [lo, hi]
+template<typename T, typename SymType>
+static void CheckSame(const Tape<T>& tape, const SymType& expr, const double lo, const double hi,
+  const char* name, const int order)
+{
+  for (int i = 0; i <= 20; ++i) {
+    const double x = lo + (hi - lo) * (0.01 + 0.049 * i);
+    if (!check::Near(tape.Evaluate(x), expr.Evaluate(x), 1e-11, name, __FILE__, __LINE__)) {
+      std::printf("  at x = %g, derivative order %d\n", x, order);
+      return;
+    }
+  }
+}
+
+// ToTape(expr) and its first three derivatives against the static ones
+template<typename SymType>
+static void CheckDerivatives(const SymType& expr, const double lo, const double hi, const char* name)
+{
+  const auto d1 = expr.Derivative();
+  const auto d2 = d1.Derivative();
+  const auto d3 = d2.Derivative();
+  const Tape<> t0 = ToTape(expr);
+  const Tape<> t1 = t0.Derivative();
+  const Tape<> t2 = t1.Derivative();
+  const Tape<> t3 = t2.Derivative();
+  CheckSame(t0, expr, lo, hi, name, 0);
+  CheckSame(t1, d1, lo, hi, name, 1);
+  CheckSame(t2, d2, lo, hi, name, 2);
+  CheckSame(t3, d3, lo, hi, name, 3);
+  MarkOps(t0);
+  MarkOps(t1);
+  MarkOps(t2);
+  MarkOps(t3);
+}
+
+
+static void Arithmetic()
+{
+  const Symbol x;
+  CheckDerivatives(sin(x) * exp(x) / (x + Int<1>()), 0.1, 2.0, "sin x e^x / (x+1)");
+  CheckDerivatives(x - cos(x) * x, -2.0, 2.0, "x - x cos x");
+  CheckDerivatives(-(x * x) + Int<3>() * x, -2.0, 2.0, "-x^2 + 3x");
+  CheckDerivatives(Int<1>() / (x * x + Int<1>()), -2.0, 2.0, "1/(x^2+1)");
+}
+
+static void Powers()
+{
+  const Symbol x;
+  CheckDerivatives(pow<3>(x) + pow<-2>(x), 0.2, 2.0, "x^3 + x^-2");
+  CheckDerivatives(x ^ x, 0.2, 2.0, "x^x");
+  CheckDerivatives(x ^ RuntimeConstant<double>(1.7), 0.2, 2.0, "x^1.7");
+  CheckDerivatives(exp(sin(x)) ^ (x + Int<1>()), -1.0, 1.0, "e^(sin x)^(x+1)");
+  CheckDerivatives(sqrt(x * x + Int<1>()), -2.0, 2.0, "sqrt(x^2+1)");
+  CheckDerivatives(ln(x) * exp(-x), 0.2, 3.0, "ln x e^-x");
+}
+
+// Constant exponents become IntegerPower only for integers up to
+// tape_max_integer_power; the rest, NaN and infinities included, stay Power
+static void ConstantExponents()
+{
+  const Symbol x;
+  CheckDerivatives(pow<-64>(x), 0.9, 1.1, "x^-64");
+  CheckDerivatives(pow<64>(x), 0.9, 1.1, "x^64");
+  CheckDerivatives(pow<65>(x), 0.9, 1.1, "x^65");
+  CheckDerivatives(x ^ RuntimeConstant<double>(2.5), 0.2, 2.0, "x^2.5");
+
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  const double inf = std::numeric_limits<double>::infinity();
+  for (const double n : { 1e10, -2147483648.0, 4294967296.0, inf, -inf, nan, 64.5 }) {
+    const Tape<> tape = ToTape(x ^ RuntimeConstant<double>(n));
+    bool integer_power = false;
+    for (const TapeInstruction& ins : tape.Instructions()) {
+      integer_power = integer_power || ins.op == TapeOp::IntegerPower;
+    }
+    SMEL_CHECK(!integer_power);
+    for (const double x0 : { 0.5, 1.0, 2.0 }) {
+      const double expected = std::pow(x0, n);
+      SMEL_CHECK((std::isnan(expected) && std::isnan(tape.Evaluate(x0))) || tape.Evaluate(x0) == expected);
+    }
+  }
+}
+
+static void Trigonometric()
+{
+  const Symbol x;
+  CheckDerivatives(sin(x), -3.0, 3.0, "sin");
+  CheckDerivatives(cos(x), -3.0, 3.0, "cos");
+  CheckDerivatives(tan(x), -1.2, 1.2, "tan");
+  CheckDerivatives(sec(x), -1.2, 1.2, "sec");
+  CheckDerivatives(cot(x), 0.2, 2.9, "cot");
+  CheckDerivatives(csc(x), 0.2, 2.9, "csc");
+}
+
+static void InverseTrigonometric()
+{
+  const Symbol x;
+  CheckDerivatives(arcsin(x), -0.9, 0.9, "arcsin");
+  CheckDerivatives(arccos(x), -0.9, 0.9, "arccos");
+  CheckDerivatives(arctan(x), -3.0, 3.0, "arctan");
+  CheckDerivatives(arcsec(x + Int<2>()), -0.8, 2.0, "arcsec");
+  CheckDerivatives(arccot(x), 0.2, 3.0, "arccot");
+  CheckDerivatives(arccsc(x + Int<2>()), -0.8, 2.0, "arccsc");
+}
+
+// The kink at 1/2 falls between the sampled inputs
+static void Abs()
+{
+  const Symbol x;
+  CheckDerivatives(abs(x - Fraction<int64_t,1,2>()) * sin(x), -1.0, 2.1, "|x - 1/2| sin x");
+}
+
+// Parameters are read at every evaluation, so tapes built before a change agree
+// with static derivatives evaluated after it
+static void Parameters()
+{
+  const Symbol x;
+  double p = 1.3;
+  const Reference<double> r(p);
+  const auto f = sin(r * x) * exp(x) + ln(x) * r + (x ^ r);
+  const auto d1 = f.Derivative();
+  const auto d2 = d1.Derivative();
+  const auto d3 = d2.Derivative();
+  const Tape<> t0 = ToTape(f);
+  const Tape<> t1 = t0.Derivative();
+  const Tape<> t2 = t1.Derivative();
+  const Tape<> t3 = t2.Derivative();
+  MarkOps(t0);
+
+  for (const double value : { 1.3, 2.0, -0.7 }) {
+    p = value;
+    CheckSame(t0, f, 0.2, 2.0, "parameter", 0);
+    CheckSame(t1, d1, 0.2, 2.0, "parameter", 1);
+    CheckSame(t2, d2, 0.2, 2.0, "parameter", 2);
+    CheckSame(t3, d3, 0.2, 2.0, "parameter", 3);
+  }
+}
+
+// Derivative<N, Budget> switches to a tape once a static derivative would be
+// larger than Budget nodes, with the same values either way
+static void Budget()
+{
+  const Symbol x;
+  const auto f = sin(x) * exp(x) / (x + Int<1>()) + ln(x);
+  const auto d3 = f.Derivative().Derivative().Derivative();
+  const auto wide = Derivative<3, 1000000>(f);
+  const auto narrow = Derivative<3, 20>(f);
+  SMEL_CHECK(!(std::is_same_v<std::decay_t<decltype(wide)>, Tape<>>));
+  SMEL_CHECK((std::is_same_v<std::decay_t<decltype(narrow)>, Tape<>>));
+  CheckSame(narrow, d3, 0.2, 2.0, "Derivative<3, 20>", 3);
+  for (int i = 0; i <= 10; ++i) {
+    const double x0 = 0.2 + 0.18 * i;
+    SMEL_CHECK_NEAR(wide.Evaluate(x0), d3.Evaluate(x0), 1e-12);
+  }
+}
+
+
+int main()
+{
+  Arithmetic();
+  Powers();
+  ConstantExponents();
+  Trigonometric();
+  InverseTrigonometric();
+  Abs();
+  Parameters();
+  Budget();
+
+  for (std::size_t op = 0; op < op_count; ++op) {
+    if (!seen[op]) {
+      std::printf("tape instruction %s never tested\n", TapeOpName(static_cast<TapeOp>(op)));
+      check::That(false, "every TapeOp is covered", __FILE__, __LINE__);
+    }
+  }
+  return check::Result();
+}